@@ -0,0 +1,122 @@
+/**
+\file
+Реализация метода Гаусса над GF(2) для упакованных по битам матриц
+*/
+#include "bitmatrix.h"
+
+#include <algorithm>
+
+using namespace std;
+namespace F4MPI{
+
+namespace{
+///наибольшее число ведущих строк в панели (таблица комбинаций содержит 2^panelRows строк)
+const int panelRows=8;
+///число строк в одной задаче пула потоков при вычитании панели
+const int rowsPerTask=64;
+
+///dst^=src для \a words слов
+inline void xorWords(uint64_t* dst, const uint64_t* src, int words){
+	for (int w=0;w<words;++w) dst[w]^=src[w];
+}
+}
+
+BitMatrix::BitMatrix(int rows, int columns):
+		nRows(rows),
+		nColumns(columns),
+		nWords((columns+63)/64),
+		data(size_t(rows)*nWords,0)
+{}
+
+void BitMatrix::flushPanel(int from, int to, int n, bool reduced, ThreadPool* pool){
+	const int above=reduced ? from : 0;
+	const int total=above+(n-to);
+	if (!total) return;
+	const int panel=to-from;
+	//все строки панели нулевые левее слова с наименьшим ведущим столбцом
+	int firstWord=nWords;
+	for (int k=from;k<to;++k) firstWord=min(firstWord,pivotColumns[k]/64);
+	const int words=nWords-firstWord;
+	/*таблица окупается, если её построение (2^panel вычитаний строк) дешевле,
+	чем вычитание в среднем panel/2 строк панели из каждой строки по отдельности*/
+	const bool useTable=uint64_t(total)*panel/2>(uint64_t(1)<<panel);
+	vector<uint64_t> table;
+	if (useTable){
+		//комбинация с номером i - сумма строк панели, соответствующих единичным битам i
+		table.assign(size_t(words)<<panel,0);
+		for (int i=1;i<(1<<panel);++i){
+			uint64_t* t=&table[size_t(i)*words];
+			const uint64_t* prev=&table[size_t(i&(i-1))*words];
+			const uint64_t* add=row(from+__builtin_ctz(i))+firstWord;
+			for (int w=0;w<words;++w) t[w]=prev[w]^add[w];
+		}
+	}
+	ThreadPool::Task task=[&](int t){
+		const int last=min(total,(t+1)*rowsPerTask);
+		for (int i=t*rowsPerTask;i<last;++i){
+			uint64_t* r=row(i<above ? i : to+(i-above));
+			//строки панели взаимно редуцированы: бит строки в ведущем столбце k-й строки панели - её коэффициент
+			unsigned index=0;
+			for (int k=0;k<panel;++k){
+				const int c=pivotColumns[from+k];
+				index|=unsigned((r[c/64]>>(c%64))&1)<<k;
+			}
+			if (!index) continue;
+			if (useTable){
+				xorWords(r+firstWord,&table[size_t(index)*words],words);
+			}else{
+				for (;index;index&=index-1){
+					const int k=__builtin_ctz(index);
+					const int w=pivotColumns[from+k]/64;
+					xorWords(r+w,row(from+k)+w,nWords-w);
+				}
+			}
+		}
+	};
+	const int tasks=(total+rowsPerTask-1)/rowsPerTask;
+	if (pool && tasks>1){
+		pool->parallelFor(tasks,task);
+	}else{
+		for (int t=0;t<tasks;++t) task(t);
+	}
+}
+
+int BitMatrix::rowEchelonForm(bool reduced, ThreadPool* pool){
+	int n=nRows;
+	pivotColumns.assign(n,-1);
+	int rank=0;
+	//текущая панель - ведущие строки [panelStart;rank)
+	int panelStart=0;
+	while (rank<n){
+		uint64_t* r=row(rank);
+		//предыдущие панели уже вычтены из строки при их заполнении, вычитаем строки текущей
+		for (int k=panelStart;k<rank;++k){
+			const int c=pivotColumns[k];
+			if ((r[c/64]>>(c%64))&1) xorWords(r+c/64,row(k)+c/64,nWords-c/64);
+		}
+		int w=0;
+		while (w<nWords && !r[w]) ++w;
+		if (w==nWords){
+			//нулевые строки переносятся в конец матрицы
+			--n;
+			if (rank!=n) swap_ranges(r,r+nWords,row(n));
+		}else{
+			const int c=w*64+__builtin_ctzll(r[w]);
+			//новая ведущая строка исключается из строк панели, чтобы панель оставалась взаимно редуцированной
+			for (int k=panelStart;k<rank;++k){
+				uint64_t* q=row(k);
+				if ((q[w]>>(c%64))&1) xorWords(q+w,r+w,nWords-w);
+			}
+			pivotColumns[rank]=c;
+			++rank;
+		}
+		if (rank>panelStart && (rank-panelStart==panelRows || rank==n)){
+			flushPanel(panelStart,rank,n,reduced,pool);
+			panelStart=rank;
+		}
+	}
+	pivotColumns.resize(rank);
+	return rank;
+}
+
+} //namespace F4MPI
@@ -0,0 +1,79 @@
+#ifndef BitMatrix_h
+#define BitMatrix_h
+/**
+\file
+Упакованное по битам представление матриц над GF(2).
+Определяет тип BitMatrix, хранящий каждый элемент матрицы одним битом, и метод Гаусса для него,
+в котором сложение строк сводится к XOR машинных слов, а вычитание набора ведущих строк -
+к одному XOR с заранее вычисленной линейной комбинацией (метод четырёх русских, M4RI).
+*/
+
+#include "threadpool.h"
+
+#include <vector>
+#include <cstdint>
+
+namespace F4MPI{
+/**Плотная матрица над GF(2).
+Строка хранится в rowWords() 64-битных словах, столбец c соответствует биту c%64 слова c/64.
+Неиспользуемые биты последнего слова строки всегда нулевые.
+*/
+class BitMatrix{
+	int nRows, nColumns, nWords;
+	std::vector<uint64_t> data;
+	///ведущие столбцы строк после rowEchelonForm()
+	std::vector<int> pivotColumns;
+
+	///вычитает панель ведущих строк [from;to) из остальных строк; см. rowEchelonForm()
+	void flushPanel(int from, int to, int n, bool reduced, ThreadPool* pool);
+  public:
+	///создаёт нулевую матрицу размера \a rows x \a columns
+	BitMatrix(int rows, int columns);
+
+	int rows()const{
+		return nRows;
+	}
+
+	int columns()const{
+		return nColumns;
+	}
+
+	///число 64-битных слов в строке
+	int rowWords()const{
+		return nWords;
+	}
+
+	uint64_t* row(int i){
+		return &data[size_t(i)*nWords];
+	}
+
+	const uint64_t* row(int i)const{
+		return &data[size_t(i)*nWords];
+	}
+
+	bool get(int i, int column)const{
+		return (row(i)[column/64]>>(column%64))&1;
+	}
+
+	void set(int i, int column){
+		row(i)[column/64]|=uint64_t(1)<<(column%64);
+	}
+
+	/**приводит матрицу к ступенчатому виду методом четырёх русских.
+	Ведущие строки собираются в панели до 8 строк, взаимно редуцированные внутри панели.
+	Для заполненной панели строится таблица всех 256 линейных комбинаций её строк,
+	и из каждой остальной строки вычитается (XOR) одна комбинация, выбираемая по битам строки в ведущих столбцах панели.
+	По окончании первые rank строк (rank - возвращаемое значение) ненулевые и имеют различные ведущие столбцы,
+	остальные строки нулевые. Порядок строк не связан с порядком ведущих столбцов.
+	\param reduced приводить ли к сильно ступенчатому виду (обнулять элементы над ведущими)
+	\param pool пул потоков для вычитания панелей или NULL
+	*/
+	int rowEchelonForm(bool reduced, ThreadPool* pool=0);
+
+	///ведущий столбец строки \a i после rowEchelonForm()
+	int pivotColumn(int i)const{
+		return pivotColumns[i];
+	}
+};
+} //namespace F4MPI
+#endif
@@ -7,6 +7,11 @@
 #include "f4main.h"
 #include "algs.h"
 #include "matrixinfoimpl.h"
+#include "rowaccumulator.h"
+#include "modpolicy.h"
+#include "simdkernels.h"
+#include "densematrix.h"
+#include "bitmatrix.h"
 #include <iostream>
 #include <algorithm>
 #include <limits>
@@ -76,14 +81,14 @@ void CMatrix::fastReduceRangeByRange(MatrixIterator mfrom, MatrixIterator mto, M
 		willNotOverflow=maxVal<(maxInt/(1+bysz));
 	}
 	if (willNotOverflow){
-		fastReduceRangeByRangeConstOverflow<true>(mfrom,mto,byfrom,byto);
+		runWithModulusPolicy<FastReduceRangeByRangeKernel<true>::WithModulus>(mfrom,mto,byfrom,byto);
 	}else{
-		fastReduceRangeByRangeConstOverflow<false>(mfrom,mto,byfrom,byto);
+		runWithModulusPolicy<FastReduceRangeByRangeKernel<false>::WithModulus>(mfrom,mto,byfrom,byto);
 	}
 }
 
-template <bool willNotOverflow> 
-void CMatrix::fastReduceRangeByRangeConstOverflow(MatrixIterator mfrom, MatrixIterator mto, MatrixIterator byfrom, MatrixIterator byto){
+template <bool willNotOverflow, class Modulus>
+void CMatrix::fastReduceRangeByRangeConstOverflow(const Modulus& mod, MatrixIterator mfrom, MatrixIterator mto, MatrixIterator byfrom, MatrixIterator byto){
 	struct alignas(typename Row::value_type) aligned_rowvaluebuf{
   	 char data[sizeof(typename Row::value_type)];
   };
@@ -192,7 +197,7 @@ void CMatrix::fastReduceRangeByRangeConstOverflow(MatrixIterator mfrom, MatrixIt
 		}
 		if (smallestcolumn!=lastcol){//перешли в следующую колонку, нужно подвинуть итераторы результата
 			for (int j=0;j<usedResRows;++j){
-				if (res[j]->value.toint() && ((res[j]->value).pureint()%=CModular::getMOD())){//получили ненулевой элемент в строке
+				if (res[j]->value.toint() && ((res[j]->value).pureint()=mod.reduce(uint32_t(res[j]->value.toint())))){//получили ненулевой элемент в строке
 					res[j]->column=lastcol;//запишем номер столбца
 					++(res[j]);//продвинем указатель
 					res[j]->value=0;//обнулим элемент, чтоб на следующем шаге не принять за новый
@@ -204,12 +209,16 @@ void CMatrix::fastReduceRangeByRangeConstOverflow(MatrixIterator mfrom, MatrixIt
 		const CModular l=m->curit->value;//число в строке, которое нужно прибавить к результату с тем или иным коэффициентом
 		const int resRow = m->row - bysz;
 		if (resRow>=0){//это редуцируемая строка; её нужно просто прибавить
-			res[resRow]->value+=l;
+			if (!willNotOverflow){
+				res[resRow]->value=mod.add(res[resRow]->value,l);
+			}else{
+				(res[resRow]->value).pureint()+=l.toint();
+			}
 		}else{//это редуцирующая строка; её нужно прибавить к нескольким с разными коэффициентеми
 			const RowCoeff *f=c+(m->row)*(msz+1);
 			if (!willNotOverflow){//известно на момент компиляции
 				while (f->coeff.toint()){//нультерменированный список коэффициентов и ссылок
-					(*(f->pRowit))->value+=f->coeff*l;//Деление на MOD здесь необходимо лишь для больших модулей
+					(*(f->pRowit))->value=mod.mulAdd((*(f->pRowit))->value,f->coeff,l);//Деление на MOD здесь необходимо лишь для больших модулей
 					++f;
 				}
 			}else{
@@ -302,6 +311,50 @@ void CMatrix::reduceRangeByMatrix(MatrixIterator mfrom, MatrixIterator mto,CMatr
 	}
 }
 
+///реализация CMatrix::denseReduceRangeByRange() для политики арифметики \a Modulus
+template <class Modulus>
+struct DenseReduceRangeByRangeKernel{
+	static void run(const Modulus& mod, CMatrix::MatrixIterator mfrom, CMatrix::MatrixIterator mto, CMatrix::MatrixIterator byfrom, CMatrix::MatrixIterator byto){
+		const int bysz=byto-byfrom;
+		int columns=0;
+		for (CMatrix::MatrixIterator i=byfrom;i!=byto;++i){
+			columns=max(columns,i->back().column+1);
+		}
+		for (CMatrix::MatrixIterator i=mfrom;i!=mto;++i){
+			if (!i->empty()) columns=max(columns,i->back().column+1);
+		}
+		//номер редуцирующей строки по её ведущему столбцу
+		vector<int> reducerOfColumn(columns,-1);
+		vector<CModular> reducerInverse(bysz);
+		for (int i=0;i<bysz;++i){
+			reducerOfColumn[(byfrom+i)->HM()]=i;
+			reducerInverse[i]=CModular::inverseMod((byfrom+i)->HC());
+		}
+		DenseRowAccumulator<Modulus> acc(mod,columns);
+		vector<pair<int,CModular> > reducersToAdd;
+		for (CMatrix::MatrixIterator m=mfrom;m!=mto;++m){
+			//набор редуцирующих строк полностью авторедуцирован,
+			//поэтому коэффициенты при них определяются исходной строкой
+			reducersToAdd.clear();
+			for (CMatrix::ConstRowit e=m->begin();e!=m->end();++e){
+				const int r=reducerOfColumn[e->column];
+				if (r<0) continue;
+				reducersToAdd.push_back(make_pair(r,mod.mul(mod.neg(e->value),reducerInverse[r])));
+			}
+			if (reducersToAdd.empty()) continue;
+			acc.load(*m);
+			for (const auto& r: reducersToAdd){
+				acc.addMultiplied(*(byfrom+r.first),r.second);
+			}
+			acc.store(*m);
+		}
+	}
+};
+
+void CMatrix::denseReduceRangeByRange(MatrixIterator mfrom, MatrixIterator mto, MatrixIterator byfrom, MatrixIterator byto){
+	runWithModulusPolicy<DenseReduceRangeByRangeKernel>(mfrom,mto,byfrom,byto);
+}
+
 ///Набор времён, замеренных разными способами
 struct MPITimeMesurement{
 #if WITH_MPI
@@ -374,6 +427,58 @@ class ResIdCalculator{
 	}
 };
 
+/**Разбиение строк [\a from;\a to) на блоки с примерно равной оценкой трудоёмкости редукции.
+Трудоёмкость редукции строки оценивается числом её ненулевых элементов: от него зависит,
+сколько редуцирующих строк придётся к ней прибавить. Число строк в каждом блоке кратно \a granularity (кроме последнего).
+\retval номера начальных строк блоков относительно \a from, завершающиеся числом строк в диапазоне
+*/
+vector<int> splitRangeByWork(CMatrix::MatrixIterator from, CMatrix::MatrixIterator to, int granularity, int blocks){
+	const int sz=to-from;
+	//постоянная добавка учитывает накладные расходы на строку, в том числе пустую
+	const long long rowOverhead=4;
+	long long totalWork=0;
+	for (CMatrix::MatrixIterator i=from;i!=to;++i){
+		totalWork+=i->size()+rowOverhead;
+	}
+	const long long blockWork=max(1LL,totalWork/blocks);
+	vector<int> starts(1,0);
+	long long curWork=0;
+	for (int row=0;row<sz;){
+		const int granuleEnd=min(sz,row+granularity);
+		for (;row<granuleEnd;++row){
+			curWork+=(from+row)->size()+rowOverhead;
+		}
+		if (curWork>=blockWork && row<sz){
+			starts.push_back(row);
+			curWork=0;
+		}
+	}
+	starts.push_back(sz);
+	return starts;
+}
+
+/**Редукция строк [\a from;\a to) по частям, распределяемым между потоками процесса.
+Строки разбиваются splitRangeByWork() на блоки с примерно равным числом ненулевых элементов, и для каждого блока вызывается \a reduceRange.
+Блоков создаётся по несколько на поток; потоки, закончившие свои блоки раньше, перехватывают блоки у остальных.
+Без пула потоков или при малом числе строк \a reduceRange вызывается один раз для всего диапазона.
+*/
+template <typename RangeReducer>
+void reduceRangeInThreads(const F4AlgData* f4options, CMatrix::MatrixIterator from, CMatrix::MatrixIterator to, int granularity, RangeReducer reduceRange){
+	const int sz=to-from;
+	ThreadPool* pool=f4options->threadPool.get();
+	const int minRowsPerThread=8;
+	granularity=max(granularity,1);
+	if (!pool || sz<2*max(granularity,minRowsPerThread)){
+		reduceRange(from,to);
+		return;
+	}
+	const int blocksPerThread=8;
+	const vector<int> starts=splitRangeByWork(from,to,granularity,pool->size()*blocksPerThread);
+	pool->parallelFor(starts.size()-1,[&](int block){
+		reduceRange(from+starts[block],from+starts[block+1]);
+	});
+}
+
 ///номер строки матрицы, с которой начинает блок \a n
 int getNthBlockStart(int n,const F4AlgData* f4options){
 	return n*f4options->MPIBlockSize;
@@ -538,7 +643,17 @@ int forwardGaussElimination(
 			continue;
 		}
 		//Отредуцировать
-		CMatrix::reduceRangeByMatrix(mymat.begin()+rowBlockStarts[lastNotProcessedBlock],mymat.end(),extramat,f4options->innerGaussBlockSize);
+		if (f4options->useDenseAccumulator){
+			reduceRangeInThreads(f4options,mymat.begin()+rowBlockStarts[lastNotProcessedBlock],mymat.end(),1,
+				[&](CMatrix::MatrixIterator from, CMatrix::MatrixIterator to){
+					CMatrix::denseReduceRangeByRange(from,to,extramat.begin(),extramat.end());
+				});
+		}else{
+			reduceRangeInThreads(f4options,mymat.begin()+rowBlockStarts[lastNotProcessedBlock],mymat.end(),f4options->innerGaussBlockSize,
+				[&](CMatrix::MatrixIterator from, CMatrix::MatrixIterator to){
+					CMatrix::reduceRangeByMatrix(from,to,extramat,f4options->innerGaussBlockSize);
+				});
+		}
 
 		totalLinesDone+=extramat.size();
 		if (f4options->mpi_start_info.thisProcessRank==resid){
@@ -605,12 +720,16 @@ void backGaussElimination(
 #endif
 		}
 		//авторедукция строк с текущего процесса по блоку
-		CMatrix::backReduceRangeByRange(
-				resultmat.begin(),
-				resultmat.begin()+lastreducibleline,
-				matrix.end()-bsize,
-				matrix.end()
-				);
+		CMatrix::MatrixIterator byfrom=matrix.end()-bsize;
+		CMatrix::MatrixIterator byto=matrix.end();
+		reduceRangeInThreads(f4options,resultmat.begin(),resultmat.begin()+lastreducibleline,1,
+			[&](CMatrix::MatrixIterator from, CMatrix::MatrixIterator to){
+				if (f4options->useDenseAccumulator){
+					CMatrix::denseReduceRangeByRange(from,to,byfrom,byto);
+				}else{
+					CMatrix::backReduceRangeByRange(from,to,byfrom,byto);
+				}
+			});
 		if (!f4options->mpi_start_info.isMainProcess()){
 			//результат больше не нужен на этом процессоре
 			matrix.clear();
@@ -747,72 +866,94 @@ void CMatrix::MPIDiagonalForm(const F4AlgData* f4options,int doAutoReduce){
 
 
 void CMatrix::toDiagonalNormalForm(const F4AlgData* f4options){
-	MPIDiagonalForm(f4options,true);
+	if (!tryGF2DiagonalForm(f4options,true)) MPIDiagonalForm(f4options,true);
 }
 
 
 void CMatrix::toRowEchelonForm(const F4AlgData* f4options){
-	MPIDiagonalForm(f4options,false);
+	if (!tryGF2DiagonalForm(f4options,false)) MPIDiagonalForm(f4options,false);
 }
 
 
-void CMatrix::reduceRowByRow(Row& row,const Row& by, CModular mb){
-	CModular c = row.getCoefByMonom(by.HM());
-	if (c!=0){
-		row.addRowMultypliedBy(by, -c*mb);
-	}
+///значение элемента, хранимого в виде CModular
+inline CModular storedValue(CModular v){
+	return v;
 }
 
+///значение элемента, хранимого в виде 16-битного вычета
+inline CModular storedValue(uint16_t v){
+	return CModular::fromReduced(v);
+}
 
-void CMatrix::eraseEmptyRows(unsigned firstRowToSearch){
-	CMatrix& m=*this;
-	unsigned i=firstRowToSearch;
-	while(i<m.size()){//Удалим пустые строки
-		if (m[i].empty()){
-			m[i].swap(m.back());
-			m.pop_back();
-			continue;
-		}else ++i;
+///элементы строки CRow для AddRowMultypliedByKernel
+struct RowElements{
+	const RowElement* elements;
+	int size;
+
+	int column(int i)const{
+		return elements[i].column;
 	}
-}
 
+	CModular value(int i)const{
+		return elements[i].value;
+	}
+};
+
+///элементы строки CSRMatrix, значения которой хранятся в типе \a Value, для AddRowMultypliedByKernel
+template <typename Value>
+struct SplitRowElements{
+	const int* columns;
+	const Value* values;
+	int size;
 
-void CRow::addRowMultypliedBy(const CRow& rowFrom, CModular multBy){
-	CRow& rowTo=*this;
-	CRow result;
+	int column(int i)const{
+		return columns[i];
+	}
 
-	//выделим память под максимально возможное число элементов
-	result.resize(rowTo.size()+rowFrom.size());
+	CModular value(int i)const{
+		return storedValue(values[i]);
+	}
+};
 
-	
-	const_iterator it1 = rowTo.begin();
-	const_iterator it1Finish = rowTo.end();
-	const_iterator it2 = rowFrom.begin();
-	const_iterator it2Finish = rowFrom.end();		
-	iterator itResult = result.begin();
-
-	if(multBy!=CModular(1)){
-		//Сложить с домножением
-		while(it1!=it1Finish && it2!=it2Finish){
-			if(it1->column==it2->column){				
-				itResult->value = it1->value+multBy*it2->value;
-				itResult->column = it1->column;
+///реализация CRow::addRowMultypliedBy() для политики арифметики \a Modulus
+template <class Modulus>
+struct AddRowMultypliedByKernel{
+	/**добавляет к строке \a rowTo элементы \a from (RowElements или SplitRowElements), домноженные на \a multBy.
+	\tparam multiply \c false, если \a multBy равен 1 и домножение не требуется
+	*/
+	template <bool multiply, class Elements>
+	static void add(const Modulus& mod, CRow& rowTo, const Elements from, CModular multBy){
+		CRow result;
+		//копия размера: запись элементов результата могла бы изменить поле from, переданное по ссылке
+		const int size2 = from.size;
+
+		//выделим память под максимально возможное число элементов
+		result.resize(rowTo.size()+size2);
+
+		CRow::const_iterator it1 = rowTo.begin();
+		CRow::const_iterator it1Finish = rowTo.end();
+		int i2 = 0;
+		CRow::iterator itResult = result.begin();
+		while(it1!=it1Finish && i2!=size2){
+			const int column2 = from.column(i2);
+			if(it1->column==column2){
+				itResult->value = multiply ? mod.mulAdd(it1->value,multBy,from.value(i2)) : mod.add(it1->value,from.value(i2));
+				itResult->column = column2;
 				++it1;
-				++it2;
+				++i2;
 				if(itResult->value!=0){
-					//result.push_back(resPair);
 					++itResult;
 				}
 			}
-			else if(it1->column<it2->column){
+			else if(it1->column<column2){
 				*itResult=*it1;
 				++it1;
 				++itResult;
 			}
 			else{
-				itResult->value = multBy*it2->value;				
-				itResult->column = it2->column;
-				++it2;
+				itResult->value = multiply ? mod.mul(multBy,from.value(i2)) : from.value(i2);
+				itResult->column = column2;
+				++i2;
 				++itResult;
 			}
 		}
@@ -821,50 +962,301 @@ void CRow::addRowMultypliedBy(const CRow& rowFrom, CModular multBy){
 			++it1;
 			++itResult;
 		}
-		while(it2!=it2Finish){
-			itResult->value = multBy*it2->value;				
-			itResult->column = it2->column;
-			++it2;
+		while(i2!=size2){
+			itResult->value = multiply ? mod.mul(multBy,from.value(i2)) : from.value(i2);
+			itResult->column = from.column(i2);
+			++i2;
 			++itResult;
 		}
-	}else{
-		//Просто сложить
-		while(it1!=it1Finish && it2!=it2Finish){
-			if(it1->column==it2->column){				
-				itResult->value = it1->value+it2->value;
-				itResult->column = it1->column;
-				++it1;
-				++it2;
-				if(itResult->value!=0){
-					//result.push_back(resPair);
-					++itResult;
+		//установим size в фактически занятый размер. Реально память при этом не освобождается
+		result.resize(itResult-result.begin());
+		rowTo.swap(result);
+	}
+
+	template <class Elements>
+	static void add(const Modulus& mod, CRow& rowTo, const Elements& from, CModular multBy){
+		if (multBy!=CModular(1)){
+			add<true>(mod,rowTo,from,multBy);
+		}else{
+			add<false>(mod,rowTo,from,multBy);
+		}
+	}
+
+	static void run(const Modulus& mod, CRow& rowTo, const CRow& rowFrom, CModular multBy){
+		add(mod,rowTo,RowElements{rowFrom.empty() ? 0 : &rowFrom.front(),int(rowFrom.size())},multBy);
+	}
+
+	static void run(const Modulus& mod, CRow& rowTo, const CSRRow& rowFrom, CModular multBy){
+		if (rowFrom.values16){
+			add(mod,rowTo,SplitRowElements<uint16_t>{rowFrom.columns,rowFrom.values16,rowFrom.size},multBy);
+		}else{
+			add(mod,rowTo,SplitRowElements<CModular>{rowFrom.columns,rowFrom.values,rowFrom.size},multBy);
+		}
+	}
+};
+
+template <class RowFrom>
+void CRow::addRowMultypliedBy(const RowFrom& rowFrom, CModular multBy){
+	runWithModulusPolicy<AddRowMultypliedByKernel>(*this,rowFrom,multBy);
+}
+template void CRow::addRowMultypliedBy(const CRow& rowFrom, CModular multBy);
+template void CRow::addRowMultypliedBy(const CSRRow& rowFrom, CModular multBy);
+
+
+///реализация CRow::normalize() для политики арифметики \a Modulus
+template <class Modulus>
+struct NormalizeRowKernel{
+	static void run(const Modulus& mod, CRow& row){
+		CModular c = CModular::inverseMod(row.HC());
+		static_assert(sizeof(RowElement)==2*sizeof(int32_t),"RowElement must be a (column, value) pair of 32-bit integers");
+		SIMD::mulModPairs(reinterpret_cast<int32_t*>(&row.front()),int(row.size()),c.toint(),mod.value());
+	}
+};
+
+void CRow::normalize(){
+	runWithModulusPolicy<NormalizeRowKernel>(*this);
+}
+
+
+///реализация CMatrix::reduceRangeByPivots() для политики арифметики \a Modulus
+template <class Modulus>
+struct ReduceRangeByPivotsKernel{
+	static void run(const Modulus& mod, CMatrix::MatrixIterator mfrom, CMatrix::MatrixIterator mto, const CSRMatrix& pivots, const vector<int>& pivotOfColumn, const vector<CModular>& pivotInverse){
+		for (CMatrix::MatrixIterator m=mfrom;m!=mto;++m){
+			CRow& row=*m;
+			unsigned pos=0;
+			while(pos<row.size()){
+				const int p=pivotOfColumn[row[pos].column];
+				if (p<0){
+					++pos;
+					continue;
 				}
+				//элемент в позиции pos обнуляется, левее него строка не меняется
+				AddRowMultypliedByKernel<Modulus>::run(mod,row,pivots[p],mod.mul(mod.neg(row[pos].value),pivotInverse[p]));
 			}
-			else if(it1->column<it2->column){
-				*itResult=*it1;
-				++it1;
-				++itResult;
+		}
+	}
+};
+
+void CMatrix::reduceRangeByPivots(MatrixIterator mfrom, MatrixIterator mto, const CSRMatrix& pivots, const vector<int>& pivotOfColumn, const vector<CModular>& pivotInverse){
+	runWithModulusPolicy<ReduceRangeByPivotsKernel>(mfrom,mto,pivots,pivotOfColumn,pivotInverse);
+}
+
+
+///реализация CMatrix::denseReduceRangeByPivots() для политики арифметики \a Modulus
+template <class Modulus>
+struct DenseReduceRangeByPivotsKernel{
+	static void run(const Modulus& mod, CMatrix::MatrixIterator mfrom, CMatrix::MatrixIterator mto, const CSRMatrix& pivots, const vector<int>& pivotOfColumn, const vector<CModular>& pivotInverse, int columns){
+		DenseRowAccumulator<Modulus> acc(mod,columns);
+		for (CMatrix::MatrixIterator m=mfrom;m!=mto;++m){
+			if (m->empty()) continue;
+			acc.load(*m);
+			//конец рабочего диапазона растёт по мере прибавления опорных строк
+			for (int c=acc.begin();c<acc.end();++c){
+				const int p=pivotOfColumn[c];
+				if (p<0) continue;
+				CModular k=acc.coefAt(c);
+				if (k==0) continue;
+				acc.addMultiplied(pivots[p],mod.mul(mod.neg(k),pivotInverse[p]));
+			}
+			acc.store(*m);
+		}
+	}
+};
+
+void CMatrix::denseReduceRangeByPivots(MatrixIterator mfrom, MatrixIterator mto, const CSRMatrix& pivots, const vector<int>& pivotOfColumn, const vector<CModular>& pivotInverse, int columns){
+	runWithModulusPolicy<DenseReduceRangeByPivotsKernel>(mfrom,mto,pivots,pivotOfColumn,pivotInverse,columns);
+}
+
+
+/**Редукция строк C|D по опорным строкам A|B и метод Гаусса для полученного блока D (см. CMatrix::ABCDDecompositionForm()).
+\param pivots опорные строки (могут содержать и другие строки, на которые не ссылается \a pivotOfColumn)
+\param pivotOfColumn номер опорной строки в \a pivots для каждого столбца, или -1
+\param nonPivots строки C|D, по окончании неопределены (портятся)
+\param reducedD матрица, в которую записывается результат
+*/
+void reduceNonPivotsAndEliminate(const CSRMatrix& pivots, const vector<int>& pivotOfColumn, int columns, CMatrix& nonPivots, CMatrix& reducedD, const F4AlgData* f4options,int doAutoReduce){
+	vector<CModular> pivotInverse(pivots.size());
+	for (int c=0;c<columns;++c){
+		const int p=pivotOfColumn[c];
+		if (p>=0) pivotInverse[p]=CModular::inverseMod(pivots[p].HC());
+	}
+	//редукция C|D по A|B: после неё в строках остаются только неведущие столбцы
+	reducedD.clear();
+	reducedD.reserve(nonPivots.size());
+	reduceRangeInThreads(f4options,nonPivots.begin(),nonPivots.end(),1,
+		[&](CMatrix::MatrixIterator from, CMatrix::MatrixIterator to){
+			if (f4options->useDenseAccumulator){
+				CMatrix::denseReduceRangeByPivots(from,to,pivots,pivotOfColumn,pivotInverse,columns);
 			}else{
-				*itResult=*it2;
-				++it2;
-				++itResult;
+				CMatrix::reduceRangeByPivots(from,to,pivots,pivotOfColumn,pivotInverse);
 			}
+		});
+	for (CMatrix::iterator i=nonPivots.begin();i!=nonPivots.end();++i){
+		if (i->empty()) continue;
+		reducedD.push_back(CMatrix::Row());
+		reducedD.back().swap(*i);
+	}
+	if (!reducedD.empty() && !reducedD.tryGF2DiagonalForm(f4options,doAutoReduce) && !reducedD.tryDenseDiagonalForm(f4options,doAutoReduce)){
+		reducedD.MPIDiagonalForm(f4options,doAutoReduce);
+	}
+}
+
+/**Сжатие столбцов для перевода матрицы в плотное представление.
+В плотную матрицу попадают только непустые столбцы матрицы \a matrix, в порядке возрастания номеров.
+\param denseColumn по окончании содержит номер плотного столбца для каждого непустого столбца
+\param sparseColumn по окончании содержит номер исходного столбца для каждого плотного столбца
+\param info по окончании содержит число непустых строк, непустых столбцов и ненулевых элементов
+*/
+void compressColumns(const CMatrix& matrix, vector<int>& denseColumn, vector<int>& sparseColumn, SingleMatrixInfo& info){
+	denseColumn.clear();
+	sparseColumn.clear();
+	info.rows=0;
+	info.elems=0;
+	for (CMatrix::const_iterator i=matrix.begin();i!=matrix.end();++i){
+		if (i->empty()) continue;
+		++info.rows;
+		info.elems+=i->size();
+		if (int(denseColumn.size())<=i->back().column) denseColumn.resize(i->back().column+1,-1);
+		for (CMatrix::Row::const_iterator j=i->begin();j!=i->end();++j){
+			denseColumn[j->column]=0;
 		}
-		while(it1!=it1Finish){
-			*itResult=*it1;
-			++it1;
-			++itResult;
+	}
+	for (int c=0;c<int(denseColumn.size());++c){
+		if (denseColumn[c]<0) continue;
+		denseColumn[c]=sparseColumn.size();
+		sparseColumn.push_back(c);
+	}
+	info.columns=sparseColumn.size();
+}
+
+bool CMatrix::tryGF2DiagonalForm(const F4AlgData* f4options,int doAutoReduce){
+	//упакованная матрица из большего числа битов не создаётся, чтобы не исчерпать память
+	const double maxBits=double(1ull<<33);
+	if (!f4options->useGF2Engine || CModular::getMOD()!=2) return false;
+	CMatrix& matrix=*this;
+	vector<int> denseColumn, sparseColumn;
+	SingleMatrixInfo info;
+	compressColumns(matrix,denseColumn,sparseColumn,info);
+	//упакованная матрица (бит на элемент) не должна быть больше разреженной (RowElement на ненулевой элемент)
+	if (info.filling()*sizeof(RowElement)*8<1) return false;
+	if (double(info.rows)*info.columns>maxBits) return false;
+
+	BitMatrix bits(info.rows,info.columns);
+	int r=0;
+	for (iterator i=matrix.begin();i!=matrix.end();++i){
+		if (i->empty()) continue;
+		for (Row::const_iterator j=i->begin();j!=i->end();++j){
+			bits.set(r,denseColumn[j->column]);
 		}
-		while(it2!=it2Finish){
-			*itResult=*it2;
-			++it2;
-			++itResult;
+		++r;
+	}
+	const int rank=bits.rowEchelonForm(doAutoReduce,f4options->threadPool.get());
+	vector<int> order(rank);
+	for (int i=0;i<rank;++i) order[i]=i;
+	sort(order.begin(),order.end(),[&](int a, int b){return bits.pivotColumn(a)<bits.pivotColumn(b);});
+	matrix.resize(rank);
+	for (int i=0;i<rank;++i){
+		const uint64_t* b=bits.row(order[i]);
+		Row& row=matrix[i];
+		int elements=0;
+		for (int w=0;w<bits.rowWords();++w) elements+=__builtin_popcountll(b[w]);
+		row.resize(elements);
+		Row::iterator e=row.begin();
+		for (int w=0;w<bits.rowWords();++w){
+			for (uint64_t word=b[w];word;word&=word-1){
+				e->column=sparseColumn[w*64+__builtin_ctzll(word)];
+				e->value=1;
+				++e;
+			}
+		}
+	}
+	return true;
+}
+
+bool CMatrix::tryDenseDiagonalForm(const F4AlgData* f4options,int doAutoReduce){
+	//плотная матрица из большего числа элементов не переводится, чтобы не исчерпать память
+	const double maxDenseElements=double(1<<28);
+	if (!f4options->denseBlockFilling) return false;
+	CMatrix& matrix=*this;
+	vector<int> denseColumn, sparseColumn;
+	SingleMatrixInfo info;
+	compressColumns(matrix,denseColumn,sparseColumn,info);
+	if (info.filling()*100<f4options->denseBlockFilling) return false;
+	if (double(info.rows)*info.columns>maxDenseElements) return false;
+
+	DenseMatrix dense(info.rows,info.columns);
+	int r=0;
+	for (iterator i=matrix.begin();i!=matrix.end();++i){
+		if (i->empty()) continue;
+		uint32_t* d=dense.row(r++);
+		for (Row::const_iterator j=i->begin();j!=i->end();++j){
+			d[denseColumn[j->column]]=j->value.toint();
 		}
 	}
-	//установим size в фактически занятый размер. Реально память при этом не освобождается 
-	result.resize(itResult-result.begin());
-	rowTo.swap(result);
-}	
+	const int rank=dense.rowEchelonForm(doAutoReduce,f4options->threadPool.get());
+	vector<int> order(rank);
+	for (int i=0;i<rank;++i) order[i]=i;
+	sort(order.begin(),order.end(),[&](int a, int b){return dense.pivotColumn(a)<dense.pivotColumn(b);});
+	matrix.resize(rank);
+	for (int i=0;i<rank;++i){
+		const uint32_t* d=dense.row(order[i]);
+		const int first=dense.pivotColumn(order[i]);
+		Row& row=matrix[i];
+		row.resize(info.columns-first-count(d+first,d+info.columns,0u));
+		Row::iterator e=row.begin();
+		for (int c=first;c<info.columns;++c){
+			if (!d[c]) continue;
+			e->column=sparseColumn[c];
+			e->value=CModular::fromReduced(d[c]);
+			++e;
+		}
+	}
+	return true;
+}
+
+void CMatrix::ABCDDecompositionForm(const CSRMatrix& rows, const F4AlgData* f4options,int doAutoReduce){
+	int columns=0;
+	for (int i=0;i<rows.size();++i){
+		columns=max(columns,rows[i].lastColumn()+1);
+	}
+	//выбор опорных строк: для каждого ведущего столбца - самая короткая строка с ним
+	vector<int> pivotOfColumn(columns,-1);
+	for (int i=0;i<rows.size();++i){
+		int& p=pivotOfColumn[rows[i].HM()];
+		if (p<0 || rows[p].size>rows[i].size) p=i;
+	}
+	//остальные строки копируются для редукции, опорные читаются прямо из rows
+	CMatrix nonPivots;
+	for (int i=0;i<rows.size();++i){
+		if (pivotOfColumn[rows[i].HM()]==i) continue;
+		nonPivots.push_back(Row());
+		rows[i].copyTo(nonPivots.back());
+	}
+	reduceNonPivotsAndEliminate(rows,pivotOfColumn,columns,nonPivots,*this,f4options,doAutoReduce);
+}
+
+
+template <class Modulus>
+void CMatrix::reduceRowByRow(const Modulus& mod, Row& row,const Row& by, CModular mb){
+	CModular c = row.getCoefByMonom(by.HM());
+	if (c!=0){
+		AddRowMultypliedByKernel<Modulus>::run(mod,row,by,mod.mul(mod.neg(c),mb));
+	}
+}
+
+
+void CMatrix::eraseEmptyRows(unsigned firstRowToSearch){
+	CMatrix& m=*this;
+	unsigned i=firstRowToSearch;
+	while(i<m.size()){//Удалим пустые строки
+		if (m[i].empty()){
+			m[i].swap(m.back());
+			m.pop_back();
+			continue;
+		}else ++i;
+	}
+}
 
 
 /*
@@ -946,65 +1338,93 @@ struct CMatrix::RowComparator{//оператор сравнения строк 
 };*/
 
 
-void CMatrix::backReduceRangeByRange(MatrixIterator mfrom, MatrixIterator mto, MatrixIterator byfrom, MatrixIterator byto){
-	for (MatrixIterator i=byfrom;i!=byto;++i){
-		CModular mb = CModular::inverseMod(i->HC());
-		for (MatrixIterator j=mfrom;j!=mto;++j){
-			reduceRowByRow(*j,*i,mb);
+///реализация CMatrix::backReduceRangeByRange() для политики арифметики \a Modulus
+template <class Modulus>
+struct CMatrix::BackReduceRangeByRangeKernel{
+	static void run(const Modulus& mod, MatrixIterator mfrom, MatrixIterator mto, MatrixIterator byfrom, MatrixIterator byto){
+		for (MatrixIterator i=byfrom;i!=byto;++i){
+			CModular mb = CModular::inverseMod(i->HC());
+			for (MatrixIterator j=mfrom;j!=mto;++j){
+				reduceRowByRow(mod,*j,*i,mb);
+			}
 		}
 	}
+};
+
+void CMatrix::backReduceRangeByRange(MatrixIterator mfrom, MatrixIterator mto, MatrixIterator byfrom, MatrixIterator byto){
+	runWithModulusPolicy<BackReduceRangeByRangeKernel>(mfrom,mto,byfrom,byto);
 }
 
 
-void CMatrix::fullAutoReduce(MatrixIterator from, MatrixIterator to){//вызывается только для маленьких матриц размера MPIblocksize
-	//прямой ход
-	for(MatrixIterator j=from;j!=to;++j){
-		if (j->empty()) continue;
-		CModular mb = CModular::inverseMod(j->HC());
-		for(MatrixIterator i=j+1;i!=to;++i){
-			if (i->empty()) continue;
-			reduceRowByRow(*i,*j,mb);
+///реализация обоих вариантов CMatrix::fullAutoReduce() для политики арифметики \a Modulus
+template <class Modulus>
+struct CMatrix::FullAutoReduceKernel{
+	static void run(const Modulus& mod, MatrixIterator from, MatrixIterator to){
+		//прямой ход
+		for(MatrixIterator j=from;j!=to;++j){
+			if (j->empty()) continue;
+			CModular mb = CModular::inverseMod(j->HC());
+			for(MatrixIterator i=j+1;i!=to;++i){
+				if (i->empty()) continue;
+				reduceRowByRow(mod,*i,*j,mb);
+			}
+		}
+		//обратный ход
+		for(MatrixIterator i = to; i!=from; --i){
+			MatrixIterator curi=i-1;
+			if (curi->empty()) continue;
+			CModular mb = CModular::inverseMod(curi->HC());
+			for(MatrixIterator j = curi; j!=from; --j){
+				MatrixIterator curj=j-1;
+				if (curj->empty()) continue;
+				reduceRowByRow(mod,*curj,*curi,mb);
+			}
 		}
 	}
-	//обратный ход
-	for(MatrixIterator i = to; i!=from; --i){
-		MatrixIterator curi=i-1;
-		if (curi->empty()) continue;
-		CModular mb = CModular::inverseMod(curi->HC());
-		for(MatrixIterator j = curi; j!=from; --j){
-			MatrixIterator curj=j-1;
-			if (curj->empty()) continue;
-			reduceRowByRow(*curj,*curi,mb);
+
+	static void run(const Modulus& mod, CMatrix& m){
+		//прямой ход
+		for(unsigned j=0;j<m.size();++j){
+			CModular mb = CModular::inverseMod(m[j].HC());
+			for(unsigned i=j+1;i<m.size();++i){
+				reduceRowByRow(mod,m[i],m[j],mb);
+			}
+			m.eraseEmptyRows(j+1);//Удалим пустые строки, начиная с j+1
+		}
+		//обратный ход
+		for(int i = m.size()-1; i>0; i--){
+			CModular mb = CModular::inverseMod(m[i].HC());
+			for(int j = i-1; j>=0; j--){
+				reduceRowByRow(mod,m[j],m[i],mb);
+			}
 		}
 	}
+};
+
+void CMatrix::fullAutoReduce(MatrixIterator from, MatrixIterator to){//вызывается только для маленьких матриц размера MPIblocksize
+	runWithModulusPolicy<FullAutoReduceKernel>(from,to);
 }
 
 
 void CMatrix::fullAutoReduce(CMatrix& m){//вызывается только для маленьких матриц размера MPIblocksize
-	//прямой ход
-	for(unsigned j=0;j<m.size();++j){
-		CModular mb = CModular::inverseMod(m[j].HC());
-		for(unsigned i=j+1;i<m.size();++i){
-			reduceRowByRow(m[i],m[j],mb);
-		}
-		m.eraseEmptyRows(j+1);//Удалим пустые строки, начиная с j+1
-	}
-	//обратный ход
-	for(int i = m.size()-1; i>0; i--){
-		CModular mb = CModular::inverseMod(m[i].HC());
-		for(int j = i-1; j>=0; j--){
-			reduceRowByRow(m[j],m[i],mb);
-		}
-	}
+	runWithModulusPolicy<FullAutoReduceKernel>(m);
 }
 
 
-void CMatrix::reduceRangeByRow(MatrixIterator mfrom, MatrixIterator mto,const Row& by){
-	CModular mb = CModular::inverseMod(by.HC());
-	for(MatrixIterator m=mfrom;m!=mto;++m){//Редуцируем все строки
-		if (m->empty()) continue;
-		reduceRowByRow(*m,by,mb);
+///реализация CMatrix::reduceRangeByRow() для политики арифметики \a Modulus
+template <class Modulus>
+struct CMatrix::ReduceRangeByRowKernel{
+	static void run(const Modulus& mod, MatrixIterator mfrom, MatrixIterator mto,const Row& by){
+		CModular mb = CModular::inverseMod(by.HC());
+		for(MatrixIterator m=mfrom;m!=mto;++m){//Редуцируем все строки
+			if (m->empty()) continue;
+			reduceRowByRow(mod,*m,by,mb);
+		}
 	}
+};
+
+void CMatrix::reduceRangeByRow(MatrixIterator mfrom, MatrixIterator mto,const Row& by){
+	runWithModulusPolicy<ReduceRangeByRowKernel>(mfrom,mto,by);
 }
 
 
@@ -1014,21 +1434,24 @@ MatrixInfo& CMatrix::getMyStats(const F4AlgData* f4options){
 
 
 
-void CMatrix::makeMatrixStats(SingleMatrixInfo & info){
+void CMatrix::makeMatrixStats(SingleMatrixInfo & info, const CSRMatrix* inputRows){
 	info.columns=getMonomialMap().size();
 	info.rows=this->size();
 	info.elems=0;
 	for(int i = 0;i<info.rows; ++i){
 		info.elems+=getRow(i).size();
 	}
-
+	if (inputRows){
+		info.rows+=inputRows->size();
+		info.elems+=inputRows->elements();
+	}
 }
 
 
-void CMatrix::doMatrixStatsPre(const F4AlgData* f4options){
+void CMatrix::doMatrixStatsPre(const F4AlgData* f4options, const CSRMatrix* inputRows){
 	if (!f4options->detailedMatrixInfo) return;
 	f4options->stats->matInfo.push_back(MatrixInfo());
-	makeMatrixStats(getMyStats(f4options).mBefore);
+	makeMatrixStats(getMyStats(f4options).mBefore,inputRows);
 	if (f4options->stats->matrixInfoFile){
 		MatrixInfo& myInfo=getMyStats(f4options);
 		char buf[1024];
@@ -16,6 +16,9 @@
 #include <ostream>
 
 namespace F4MPI{
+class CSRMatrix;
+struct CSRRow;
+
 /**
 Структура для хранения элемента строки.
 Поскольку матрица является разреженной, хранятся только ненулевые элементы строк.
@@ -40,8 +43,10 @@ struct RowElement{
 struct CRow:public PODvector<RowElement>{
 //struct CRow:public vector<RowElement >{
 
-	///добавляет к строке rowTo строку rowFrom, домноженную на multBy
-	void addRowMultypliedBy(const CRow& rowFrom, CModular multBy);
+	/**добавляет к строке rowTo строку rowFrom, домноженную на multBy.
+	\tparam RowFrom тип строки \a rowFrom: CRow или CSRRow (строка непрерывно хранимой матрицы)
+	*/
+	template <class RowFrom> void addRowMultypliedBy(const RowFrom& rowFrom, CModular multBy);
 
 	///Базовый контейнер (массив) для хранения отдельных элементов
 	typedef PODvector<RowElement> BaseContainer;
@@ -60,12 +65,7 @@ struct CRow:public PODvector<RowElement>{
 	Нормализует строку, т.е. домножает все элементы строки на коэффициент обратный ведущему (первому ненулевому).
 	Таким образом ведущий элемент становится единичным.
 	*/
-	void normalize(){
-		CModular c  = CModular::inverseMod(HC());	
-		for(unsigned i = 0; i<size(); i++){
-			(*this)[i].value = (*this)[i].value*c;
-		}
-	}
+	void normalize();
 
 	/**
 	возвращает численное значение ведущего элемента строки.
@@ -163,16 +163,17 @@ public:
 	*/
 	MatrixInfo& getMyStats(const F4AlgData* f4options);
 
-	///Записывает статистику по текущему состоянию матрицы в заданную переменную
-	void makeMatrixStats(SingleMatrixInfo &);
+	///Записывает статистику по текущему состоянию матрицы (и строкам \a inputRows, если заданы) в заданную переменную
+	void makeMatrixStats(SingleMatrixInfo &, const CSRMatrix* inputRows=0);
 
 	/**
 	Работа со статистикой до приведения матрицы к ступенчатому виду.
 	Добавляет в массив статистических данных новый элемент, соответсвующий текущей матрице,
 	записывает статистику по текущему (до редукции) состоянию, также выводит его в файл.
+	Строки матрицы, переданные для редукции в непрерывном виде \a inputRows, учитываются в статистике наравне с собственными.
 	Если статистика отключена, ничего не делает.
 	*/
-	void doMatrixStatsPre(const F4AlgData* f4options);
+	void doMatrixStatsPre(const F4AlgData* f4options, const CSRMatrix* inputRows=0);
 
 	/**
 	Работа со статистикой после приведения матрицы к ступенчатому виду.
@@ -243,8 +244,9 @@ private:
 	\param mb обратный к ведущему элементу строки \a by.
 	Для нескольких вызовов с разными \a row строка \a by одинакова,
 	и чтоб не вычислять обратный каждый раз заново он вычисляется и передаётся отдельно.
+	\param mod политика арифметики по модулю (см. modpolicy.h), выбранная вызывающим ядром
 	*/
-	static void reduceRowByRow(Row& row,const Row& by, CModular mb);
+	template <class Modulus> static void reduceRowByRow(const Modulus& mod, Row& row,const Row& by, CModular mb);
 
 	///удаляет из матрицы пустые строки, начиная поиск таких с \a firstRowToSearch
 	void eraseEmptyRows(unsigned firstRowToSearch=0);
@@ -252,6 +254,11 @@ private:
 	///редуцирует каждую строку набора [\a mfrom;\a mto) по строке by
 	static void reduceRangeByRow(MatrixIterator mfrom, MatrixIterator mto,const Row& by);
 
+	//ядра reduceRangeByRow(), backReduceRangeByRange() и fullAutoReduce() для runWithModulusPolicy(). Документированы в реализации
+	template <class Modulus> struct ReduceRangeByRowKernel;
+	template <class Modulus> struct BackReduceRangeByRangeKernel;
+	template <class Modulus> struct FullAutoReduceKernel;
+
 	//для fastReduceRangeByRange. Документировано в реализации
 	struct PairCurEnd;
 	struct RowCoeff;
@@ -273,8 +280,18 @@ public:
 	Если он равен \c true, то взятие по модулю происходит только после суммирования,
 	иначе взятие по модулю производится для каждого слагаемого (являющегося произведением двух чисел).
 	Вынесен в шаблонный параметр, чтоб быть известным во время компиляции, что позволит компилятору породить более оптимальный код в самом главном внутреннем цикле программы.
+	\tparam Modulus политика арифметики по модулю (см. modpolicy.h), по той же причине известная во время компиляции
 	*/
-	template <bool willNotOverflow> static void fastReduceRangeByRangeConstOverflow(MatrixIterator mfrom, MatrixIterator mto, MatrixIterator byfrom, MatrixIterator byto);
+	template <bool willNotOverflow, class Modulus> static void fastReduceRangeByRangeConstOverflow(const Modulus& mod, MatrixIterator mfrom, MatrixIterator mto, MatrixIterator byfrom, MatrixIterator byto);
+
+	///обёртка над fastReduceRangeByRangeConstOverflow() для вызова через runWithModulusPolicy()
+	template <bool willNotOverflow> struct FastReduceRangeByRangeKernel{
+		template <class Modulus> struct WithModulus{
+			static void run(const Modulus& mod, MatrixIterator mfrom, MatrixIterator mto, MatrixIterator byfrom, MatrixIterator byto){
+				fastReduceRangeByRangeConstOverflow<willNotOverflow>(mod,mfrom,mto,byfrom,byto);
+			}
+		};
+	};
 
 	/**
 	редуцирует подматрицу по матрице с заданным размером блока.
@@ -285,6 +302,17 @@ public:
 	*/
 	static void reduceRangeByMatrix(MatrixIterator mfrom, MatrixIterator mto, CMatrix& by, int blocksize);
 
+	/**
+	редуцирует подматрицу по подматрице через плотный аккумулятор.
+	Каждая строка набора [\a mfrom;\a mto) разворачивается в DenseRowAccumulator,
+	к ней прибавляются с нужными коэффициентами все строки [\a byfrom;\a byto) без промежуточного взятия по модулю,
+	после чего результат сворачивается обратно в разреженную строку.
+	Требуется, чтоб редуцирующий набор [\a byfrom;\a byto) был полностью авторедуцирован:
+	тогда все коэффициенты определяются по исходной строке до начала прибавлений.
+	Используется вместо reduceRangeByMatrix() и backReduceRangeByRange() при включённой опции useDenseAccumulator.
+	*/
+	static void denseReduceRangeByRange(MatrixIterator mfrom, MatrixIterator mto, MatrixIterator byfrom, MatrixIterator byto);
+
 	/**\details
 	редуцирует подматрицу по подматрице (версия для обратного хода).
 	Отличается от обычной тем, что есть дополнительное предусловие:
@@ -292,6 +320,68 @@ public:
 	*/
 	static void backReduceRangeByRange(MatrixIterator mfrom, MatrixIterator mto, MatrixIterator byfrom, MatrixIterator byto);
 
+	/**
+	редуцирует каждую строку набора [\a mfrom;\a mto) по набору опорных строк с различными ведущими столбцами.
+	Столбцы строки просматриваются по возрастанию, и каждый ненулевой элемент в столбце,
+	который является ведущим для опорной строки, обнуляется вычитанием этой строки.
+	Поскольку опорная строка не содержит ненулей левее своего ведущего столбца, уже просмотренная часть строки не меняется.
+	Опорные строки не обязаны быть авторедуцированы.
+	\param pivots матрица, содержащая опорные строки
+	\param pivotOfColumn номер опорной строки в \a pivots для каждого столбца, или -1, если столбец не ведущий
+	\param pivotInverse обратные к ведущим элементам опорных строк (по номеру строки в \a pivots)
+	*/
+	static void reduceRangeByPivots(MatrixIterator mfrom, MatrixIterator mto, const CSRMatrix& pivots, const std::vector<int>& pivotOfColumn, const std::vector<CModular>& pivotInverse);
+
+	/**
+	редуцирует набор строк [\a mfrom;\a mto) по опорным строкам через плотный аккумулятор.
+	Результат совпадает с результатом reduceRangeByPivots(),
+	но прибавление опорных строк выполняется в DenseRowAccumulator с отложенным взятием по модулю.
+	\param columns число столбцов матрицы
+	*/
+	static void denseReduceRangeByPivots(MatrixIterator mfrom, MatrixIterator mto, const CSRMatrix& pivots, const std::vector<int>& pivotOfColumn, const std::vector<CModular>& pivotInverse, int columns);
+
+	/**Редукция с блочной декомпозицией A|B/C|D (метод Фожера-Лашартра).
+	Для каждого ведущего столбца выбирается одна (самая короткая) опорная строка.
+	Опорные строки образуют треугольные блоки A|B, все остальные строки - блоки C|D.
+	Строки C|D редуцируются по A|B, после чего в них остаются только неведущие столбцы (блок D),
+	и метод Гаусса (MPIDiagonalForm()) применяется только к полученному блоку D.
+	В F4 строки матрицы, полученные из препроцессинга, являются опорными, поэтому почти вся работа сводится
+	к однократной редукции строк S-многочленов без прямого хода метода Гаусса по строкам-редукторам.
+
+	По окончании матрица содержит только строки редуцированного блока D.
+	Опорные строки отбрасываются, так как их ведущие мономы уже являются ведущими мономами исходных строк,
+	и результат F4 из них не формируется.
+	Исходные строки берутся из \a rows, а не из самой матрицы,
+	которая к моменту вызова должна быть пуста (но уже содержать соответствие мономов столбцам).
+	Опорные строки используются прямо из \a rows без копирования, в отдельные строки CRow копируются только строки C|D.
+	\param rows исходные строки матрицы
+	\param f4options параметры, переданные алгоритму F4 (используются при редукции блока D)
+	\param doAutoReduce указывает на необходимость доведения блока D до сильно ступенчатого вида
+	*/
+	void ABCDDecompositionForm(const CSRMatrix& rows, const F4AlgData* f4options,int doAutoReduce=true);
+
+	/**Исключение над GF(2) в упакованном по битам виде.
+	При модуле 2 и включённой опции F4AlgOptions::useGF2Engine непустые столбцы матрицы переносятся в BitMatrix,
+	которая приводится к ступенчатому виду методом четырёх русских, и результат записывается обратно
+	в разреженные строки, упорядоченные по ведущему столбцу.
+	Матрица не переводится, если упакованная форма заняла бы больше памяти, чем разреженная.
+	\param f4options параметры, переданные алгоритму F4 (опция useGF2Engine и пул потоков)
+	\param doAutoReduce указывает на необходимость доведения до сильно ступенчатого вида
+	\retval true, если матрица приведена, false, если упакованная форма не используется (тогда матрица не меняется)
+	*/
+	bool tryGF2DiagonalForm(const F4AlgData* f4options,int doAutoReduce=true);
+
+	/**Плотное исключение заполненной матрицы.
+	Если доля ненулевых элементов в непустых столбцах матрицы не меньше порога F4AlgOptions::denseBlockFilling,
+	непустые столбцы переносятся в DenseMatrix, которая приводится к ступенчатому виду блочным плотным методом Гаусса,
+	и результат записывается обратно в разреженные строки, упорядоченные по ведущему столбцу.
+	Используется вместо MPIDiagonalForm() для блока D при блочной декомпозиции.
+	\param f4options параметры, переданные алгоритму F4 (порог заполненности и пул потоков)
+	\param doAutoReduce указывает на необходимость доведения до сильно ступенчатого вида
+	\retval true, если матрица приведена, false, если она слишком разрежена (тогда матрица не меняется)
+	*/
+	bool tryDenseDiagonalForm(const F4AlgData* f4options,int doAutoReduce=true);
+
 	/**Параллельная версия метода Гаусса.
 	Метод Гаусса, распаралелленный с помощью MPI.
 	\param f4options параметры, переданные алгоритму F4 (размеры блоков, опции статистики, и т.д.)
@@ -299,10 +389,10 @@ public:
 	*/
 	void MPIDiagonalForm(const F4AlgData* f4options,int doAutoReduce=true);
 
-	///Параллельно приводит матрицу к сильно ступенчатому виду (с помощью MPIDiagonalForm())
+	///Параллельно приводит матрицу к сильно ступенчатому виду (с помощью MPIDiagonalForm() или, над GF(2), tryGF2DiagonalForm())
 	void toDiagonalNormalForm(const F4AlgData* f4options);
 	
-	///Параллельно приводит матрицу к обычному ступенчатому виду (с помощью MPIDiagonalForm())
+	///Параллельно приводит матрицу к обычному ступенчатому виду (с помощью MPIDiagonalForm() или, над GF(2), tryGF2DiagonalForm())
 	void toRowEchelonForm(const F4AlgData* f4options);
 };
 } //namespace F4MPI
@@ -107,6 +107,13 @@ class CModular{
 		return val;
 	}
 
+	///создаёт элемент из заведомо приведённого значения \a reducedValue (от 0 до \c MOD-1) без взятия по модулю
+	static CModular fromReduced(int reducedValue){
+		CModular res;
+		res.val=reducedValue;
+		return res;
+	}
+
 	/**
 	отношение порядка на вычетах.
 	Рассматривает вычеты как числа от 0 до \c MOD-1
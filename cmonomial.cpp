@@ -8,12 +8,36 @@
 #include "memorymanager.h"
 
 namespace F4MPI{
-template<> size_t PODvecSize<CInternalMonomial>::iterator_step=0;
 
 CMonomialBase::Order CMonomialBase::order;
 int CMonomialBase::orderParam = 0;
 int CMonomialBase::theNumberOfVariables = 0;
 int CMonomialBase::degreessize = 0;
+int CMonomialBase::degreeBytes = 1;
+int CMonomialBase::maxDegree = 100;
+int CMonomialBase::degsPerWord = 8;
+CMonomialBase::DegWord CMonomialBase::laneLowBits = 0x0101010101010101ull;
+CMonomialBase::DegWord CMonomialBase::laneHighBits = 0x8080808080808080ull;
+CMonomialBase::DegWord CMonomialBase::firstLaneBits = 0xFF;
+int CMonomialBase::degreeWords = 0;
+int CMonomialBase::sparseTerms = 0;
+const int CMonomialBase::sparseMaxTerms;
+const int CMonomialBase::sparseWords;
+int CMonomialBase::divMaskOffset = 0;
+int CMonomialBase::hashOffset = 0;
+std::vector<CMonomialBase::DegWord> CMonomialBase::hashMultipliers;
+int CMonomialBase::orderKeyOffset = 0;
+std::vector<CMonomialBase::OrderKeyLane> CMonomialBase::orderKeyLanes;
+CMonomialBase::DegWord CMonomialBase::orderKeyOfOne = 0;
+CMonomialBase::Order CMonomialBase::orderKeyOrder;
+bool CMonomialBase::orderKeyComplete = false;
+CMonomialBase::DegWord CMonomialBase::orderKeyMask = 0;
+CMonomialBase::DegWord CMonomialBase::orderKeyForwardMask = 0;
+CMonomialBase::DegWord CMonomialBase::orderKeyReversedMask = 0;
+CMonomialBase::DegWord CMonomialBase::orderKeyTotalMask = 0;
+bool CMonomialBase::orderKeyPerVariable = false;
+int CMonomialBase::divMaskVariables = 0;
+int CMonomialBase::divMaskBitsPerVariable = 0;
 
 CMonomialBase::Order CMonomialBase::getOrder(){
 	return order;
@@ -21,6 +45,62 @@ CMonomialBase::Order CMonomialBase::getOrder(){
 void CMonomialBase::setOrder(CMonomialBase::Order ord, int anOrderParam){
 	order = ord;
 	orderParam = anOrderParam;
+	//ключи уже созданных мономов построены для прежнего порядка; новые строятся в setNumberOfVariables()
+	orderKeyOrder = Order(0);
+}
+
+void CMonomialBase::setupOrderKey(){
+	const int n = theNumberOfVariables;
+	std::vector<OrderKeyLane> lanes;
+	//блок переменных [from;to), упорядоченный degrevlex: степень блока, затем дополненные степени от последней;
+	//первая переменная блока определяется остальными и степенью блока
+	auto addRevLexBlock = [&lanes](int from, int to){
+		lanes.push_back(OrderKeyLane{from, to, false});
+		for (int i = to-1; i>from; --i) lanes.push_back(OrderKeyLane{i, i+1, true});
+	};
+	switch (order){
+		case lexOrder:
+			for (int i = 1; i<=n; ++i) lanes.push_back(OrderKeyLane{i, i+1, false});
+			break;
+		case deglexOrder:
+			lanes.push_back(OrderKeyLane{0, 1, false});
+			for (int i = 1; i<n; ++i) lanes.push_back(OrderKeyLane{i, i+1, false});
+			break;
+		case degrevlexOrder:
+			addRevLexBlock(1, n+1);
+			lanes.front() = OrderKeyLane{0, 1, false};//суммарная степень уже хранится
+			break;
+		case blklexOrder:
+			addRevLexBlock(1, orderParam+1);
+			addRevLexBlock(orderParam+1, n+1);
+			break;
+		default: throw std::logic_error("Unknown monomial order");
+	}
+	orderKeyComplete = int(lanes.size())<=degsPerWord;
+	if (!orderKeyComplete) lanes.resize(degsPerWord);
+	orderKeyLanes = lanes;
+	orderKeyOfOne = 0;
+	orderKeyMask = 0;
+	orderKeyForwardMask = 0;
+	orderKeyReversedMask = 0;
+	orderKeyTotalMask = 0;
+	orderKeyPerVariable = true;
+	for (size_t j = 0; j<lanes.size(); ++j){
+		const int shift = 64-8*degreeBytes*(j+1);
+		const DegWord laneBits = firstLaneBits << shift;
+		orderKeyMask |= laneBits;
+		if (lanes[j].from==0){
+			orderKeyTotalMask |= laneBits;
+		}else if (lanes[j].to!=lanes[j].from+1){
+			orderKeyPerVariable = false;
+		}else if (lanes[j].reversed){
+			orderKeyReversedMask |= laneBits;
+			orderKeyOfOne |= (firstLaneBits>>1) << shift;
+		}else{
+			orderKeyForwardMask |= laneBits;
+		}
+	}
+	orderKeyOrder = order;
 }
 
 std::string CMonomialBase::varName(int varIdxFrom1, ParserVarNames* names)
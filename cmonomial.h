@@ -11,6 +11,9 @@
 #include <sstream>
 #include <stdexcept>
 #include <cassert>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
 
 #include "globalf4.h"
 
@@ -18,6 +21,15 @@ namespace F4MPI{
 
 typedef std::vector<std::string> ParserVarNames;
 
+/**Исключение, возникающее при выходе степени монома за пределы CMonomialBase::maxDegree
+(или числа переменных разреженного монома за пределы CMonomialBase::sparseTerms).
+Позволяет отличить переполнение степени от прочих ошибок и повторить вычисление с большей шириной степеней.
+*/
+class DegreeOverflow: public std::runtime_error{
+  public:
+	explicit DegreeOverflow(const std::string& what): std::runtime_error(what){}
+};
+
 /**определение базовых операций над мономамами.
 Этот класс лишь оределяет операции над мономами, которые ипользуют отнаследованные от него классы,
 но не имеет никаких данных и нестатических функций.
@@ -45,258 +57,993 @@ class CMonomialBase{
 
 	/**\details
 	число байт, занимаемых данными монома.
-	Данные сотоят из последовательно расположенной суммарной степени и набора степеней по отдельным переменным.
-	Поэтому degreessize должно быть равно (\c #theNumberOfVariables + 1)*(число байт, занимаемое одной степенью)
+	Данные сотоят из последовательно расположенной суммарной степени, набора степеней по отдельным переменным
+	(каждая степень занимает #degreeBytes байт), дополненного нулями до #degreeWords слов типа #DegWord,
+	хеша (см. hash()), расположенного со смещением #hashOffset, ключа порядка (см. orderKey()), расположенного со смещением #orderKeyOffset,
+	и маски делимости (см. #DivMask), расположенной со смещением #divMaskOffset.
+	Поэтому degreessize должно быть равно #divMaskOffset + sizeof(#DivMask)
 	*/
 	static int degreessize;
-  
-	static const int MAX_DEGREE = 100;
-	
+
+	///Тип степени во внешнем интерфейсе монома (при создании по вектору степеней и при чтении степеней)
+	typedef int Deg;
+
+	///Единица хранения данных монома; степени хранятся в #degreeBytes таких единицах каждая
+	typedef signed char DegData;
+
+	/**\details
+	Число байт, занимаемых одной степенью (глобальный параметр): 1, 2 или 4.
+	Выбирается при инициализации по ожидаемой степени задачи: малые задачи используют компактное 8-битное представление,
+	а для больших степеней данные монома становятся длиннее. Поэлементные операции над степенями
+	инстанцированы для каждой ширины (шаблоны с параметром Lane) и выбираются одним переключением по degreeBytes на вызов.
+	*/
+	static int degreeBytes;
+
+	/**\details
+	Наибольшая допустимая суммарная степень (глобальный параметр, зависит от #degreeBytes).
+	Превышение приводит к исключению DegreeOverflow, после которого вычисление можно повторить с большей шириной степеней.
+	*/
+	static int maxDegree;
+
+	/**\details
+	Машинное слово, в котором упакованы несколько степеней монома (по #degsPerWord в слове).
+	Поскольку степени неотрицательны и не превосходят #maxDegree, старший бит каждой степени нулевой,
+	поэтому умножение и деление мономов выполняются одним сложением/вычитанием слов без переносов между степенями,
+	а сравнение степеней всего слова - одним вычитанием (SWAR, SIMD within a register): см. compareLanes().
+	*/
+	typedef uint64_t DegWord;
+
+	///число степеней в одном слове #DegWord
+	static int degsPerWord;
+
+	///слово, в котором у каждой степени установлен только младший бит
+	static DegWord laneLowBits;
+
+	///слово, в котором у каждой степени установлен только старший бит
+	static DegWord laneHighBits;
+
+	///слово, в котором установлены все биты только первой (младшей) степени
+	static DegWord firstLaneBits;
+
+	///число слов #DegWord, занимаемых суммарной степенью и степенями переменных (неиспользуемые степени последнего слова нулевые)
+	static int degreeWords;
+
+	/**\details
+	Число переменных, помещающихся в разреженный моном, или 0, если мономы плотные (глобальный параметр).
+	Разреженное представление предназначено для задач с сотнями переменных, в каждом мономе которых лишь несколько из них.
+	Первое слово степеней разреженного монома содержит суммарную степень (16 бит, как при #degreeBytes = 2) и число его переменных,
+	следующие слова - пары (переменная, степень) по возрастанию номеров переменных, по 32 бита на пару (см. sparseTerm()).
+	Неиспользуемые пары нулевые, поэтому равенство мономов, как и в плотном представлении, проверяется сравнением слов.
+	Хеш - сумма степеней, умноженных на случайные множители их переменных, и остаётся линейным по степеням.
+	Если моном не помещается, возникает DegreeOverflow, после которого вычисление повторяется с большей ёмкостью или с плотными мономами.
+	*/
+	static int sparseTerms;
+
+	///наибольшая ёмкость разреженного монома (#sparseTerms)
+	static const int sparseMaxTerms = 256;
+
+	/**\details
+	Маска делимости монома.
+	Каждой из первых #divMaskVariables переменных отводится #divMaskBitsPerVariable битов маски,
+	j-й из которых установлен, если степень переменной больше j.
+	Если моном a делится на моном b, то все биты маски b установлены и в маске a,
+	поэтому большинство проверок делимости, дающих отрицательный ответ, решается одной операцией AND без просмотра степеней.
+	Маска вычисляется при каждом изменении степеней и хранится вместе с ними.
+	*/
+	typedef uint32_t DivMask;
+
+	///смещение маски делимости от начала данных монома (в байтах), выровненное по размеру маски
+	static int divMaskOffset;
+
+	///смещение хеша (см. hash()) от начала данных монома (в байтах), сразу за словами степеней
+	static int hashOffset;
+
+	///нечётные случайные множители слов степеней в хеше (см. hash()), по одному на слово (для разреженных мономов - на переменную)
+	static std::vector<DegWord> hashMultipliers;
+
+	///смещение ключа порядка (см. orderKey()) от начала данных монома (в байтах)
+	static int orderKeyOffset;
+
+	/**\details
+	Одна степень ключа порядка: сумма степеней [from;to) (степень 0 - суммарная),
+	а при reversed - её дополнение до #firstLaneBits/2, так что меньшая степень даёт больший ключ.
+	Все степени ключа, как и степени монома, меньше #firstLaneBits/2, поэтому к ключам применимо compareLanes().
+	*/
+	struct OrderKeyLane{
+		int from, to;
+		bool reversed;
+	};
+
+	///степени ключа порядка, начиная со старшей
+	static std::vector<OrderKeyLane> orderKeyLanes;
+
+	///ключ порядка монома 1 (без переменных); ключ аффинен по степеням: key(a*b) = key(a)+key(b)-key(1)
+	static DegWord orderKeyOfOne;
+
+	///порядок, для которого вычислены ключи (см. orderKey()); ключи не используются при сравнении по другим порядкам
+	static Order orderKeyOrder;
+
+	///совпадение ключей означает равенство мономов (в ключ поместились все степени, определяющие порядок)
+	static bool orderKeyComplete;
+
+	///биты ключа порядка, занятые степенями из #orderKeyLanes
+	static DegWord orderKeyMask;
+
+	///биты ключа порядка, занятые степенями отдельных переменных, соответственно прямыми и дополненными
+	static DegWord orderKeyForwardMask, orderKeyReversedMask;
+
+	///биты ключа порядка, занятые суммарной степенью (старшая степень ключа для deglex и degrevlex, иначе 0)
+	static DegWord orderKeyTotalMask;
+
+	///ключ состоит только из суммарной степени и степеней отдельных переменных (порядок не blklex)
+	static bool orderKeyPerVariable;
+
+	///число переменных, степени которых представлены в маске делимости
+	static int divMaskVariables;
+
+	///число битов маски делимости, отводимых одной переменной
+	static int divMaskBitsPerVariable;
+
 	///возвращает код порядка на мономах
 	static Order getOrder();
 
 	///устанавливает порядок с кодом \a ord на мономах.
 	static void setOrder(Order ord, int orderParameter);
     
-	///устанавливает число переменных равным \a n (и degreessize соотвественно)
-	static void setNumberOfVariables(int n){
-		//static const int varsInHash=sizeof(int)/sizeof(Deg);
+	/**\details
+	Устанавливает число переменных равным \a n, а ширину степени - \a bytesPerDegree байт (и degreessize соотвественно).
+	При ненулевом \a sparseCapacity мономы разреженные (см. #sparseTerms) с ёмкостью не меньше \a sparseCapacity переменных;
+	их степени 16-битные, поэтому \a bytesPerDegree должно быть равно 2.
+	*/
+	static void setNumberOfVariables(int n, int bytesPerDegree = 1, int sparseCapacity = 0){
 		//warning! This assume little endian arch;
-		//static const int[] hashMasks={0,0x000000FF,0x0000FFFF};
+		if (bytesPerDegree!=1 && bytesPerDegree!=2 && bytesPerDegree!=4) throw std::invalid_argument("unsupported monomial degree width");
+		if (sparseCapacity && (bytesPerDegree!=2 || sparseCapacity>sparseMaxTerms || n>=0xFFFF)) throw std::invalid_argument("unsupported sparse monomial capacity");
+		degreeBytes=bytesPerDegree;
+		maxDegree=bytesPerDegree==1 ? 100 : int((uint64_t(1)<<(8*bytesPerDegree-1))-1);
+		degsPerWord=sizeof(DegWord)/bytesPerDegree;
+		firstLaneBits=(DegWord(1)<<(8*bytesPerDegree))-1;
+		laneLowBits=~DegWord(0)/firstLaneBits;
+		laneHighBits=laneLowBits<<(8*bytesPerDegree-1);
 
 		theNumberOfVariables=n;
-		degreessize=(n+1)*sizeof(Deg);
+		if (sparseCapacity){
+			//не меньше 5 слов: такие числа слов не инстанцируются отдельно и выбираются в CMONOMIAL_DISPATCH_WORDS вместе с sparseWords
+			degreeWords=std::max(5, 1+(sparseCapacity+1)/2);
+			sparseTerms=2*(degreeWords-1);
+		}else{
+			degreeWords=(n+1+degsPerWord-1)/degsPerWord;
+			if (degreeWords==3) degreeWords=4;//для инстанцирования под 4 слова (см. wordsOf())
+			sparseTerms=0;
+		}
+		hashOffset=degreeWords*sizeof(DegWord);
+		orderKeyOffset=hashOffset+sizeof(DegWord);
+		divMaskOffset=orderKeyOffset+sizeof(DegWord);
+		degreessize=divMaskOffset+sizeof(DivMask);
+		hashMultipliers.resize(sparseTerms ? n+1 : degreeWords);
+		//splitmix64: множители фиксированы, чтобы хеши и порядок обхода хеш-таблиц не менялись от запуска к запуску
+		DegWord seed=0x9E3779B97F4A7C15ull;
+		for(DegWord& m: hashMultipliers){
+			DegWord z=(seed+=0x9E3779B97F4A7C15ull);
+			z=(z^(z>>30))*0xBF58476D1CE4E5B9ull;
+			z=(z^(z>>27))*0x94D049BB133111EBull;
+			m=(z^(z>>31))|1;
+		}
+		divMaskVariables=std::min<int>(n,8*sizeof(DivMask));
+		divMaskBitsPerVariable=divMaskVariables ? 8*sizeof(DivMask)/divMaskVariables : 0;
+		setupOrderKey();
 	}
-
-	//typedef int Deg;
-	///Тип для хранения степеней - как суммарной, так и каждой переменной
-	typedef signed char Deg;//На очень больших примерах может понадобиться заменить signed char на signed short
   protected:
+	/**\details
+	Строит #orderKeyLanes для текущих порядка, числа переменных и ширины степеней.
+	Последовательность степеней ключа повторяет порядок их сравнения: суммарная степень (или степень блока для blklex),
+	затем степени переменных - первые для lex и deglex, последние в обратном порядке и дополненные для degrevlex и blklex.
+	Степени, не поместившиеся в одно слово, отбрасываются, и тогда #orderKeyComplete ложно.
+	*/
+	static void setupOrderKey();
+
+	///возвращает \a w-е слово степеней монома \a degrees
+	static inline DegWord getWord(const DegData *degrees, int w){
+		DegWord word;
+		memcpy(&word, reinterpret_cast<const char*>(degrees)+w*sizeof(DegWord), sizeof(word));
+		return word;
+	}
+
+	///записывает \a word в \a w-е слово степеней монома \a degrees
+	static inline void setWord(DegData *degrees, int w, DegWord word){
+		memcpy(reinterpret_cast<char*>(degrees)+w*sizeof(DegWord), &word, sizeof(word));
+	}
+
+	/**\details
+	Поразрядное сравнение упакованных степеней: возвращает слово, в котором старший бит каждой степени установлен,
+	если соответствующая степень \a a не меньше степени \a b, а остальные биты нулевые.
+	Установленный старший бит степени \a a не даёт заёму распространиться на соседнюю степень.
+	*/
+	static inline DegWord compareLanes(DegWord a, DegWord b){
+		return ((a | laneHighBits) - b) & laneHighBits;
+	}
+
+	/**\details
+	Число слов степеней в функциях, инстанцированных для \a Words слов: 1, 2 или 4 слова
+	(до 7, 15 и 31 переменной при 8-битных степенях) известны при компиляции, и циклы по словам полностью разворачиваются,
+	а 0 означает произвольное число слов #degreeWords.
+	*/
+	template <int Words> static inline int wordsOf(){
+		return Words>0 ? Words : degreeWords;
+	}
+
+	/**\details
+	Значение параметра Words функций, выбираемое для разреженных мономов (см. #sparseTerms).
+	Функции, которым достаточно слов степеней (копирование, сравнение на равенство), обрабатывают такие мономы как плотные из #degreeWords слов,
+	остальные переходят к разреженным реализациям.
+	*/
+	static const int sparseWords = -1;
+
+/**\details
+Возвращает результат функции \a f\<Words\>(...), инстанцированной для текущего числа слов степеней CMonomialBase::degreeWords (см. CMonomialBase::wordsOf()),
+или для разреженных мономов (CMonomialBase::sparseWords). Выбор делается одним хорошо предсказываемым переходом на вызов.
+*/
+#define CMONOMIAL_DISPATCH_WORDS(f, ...) \
+	switch (degreeWords){ \
+		case 1: return f<1>(__VA_ARGS__); \
+		case 2: return f<2>(__VA_ARGS__); \
+		case 4: return f<4>(__VA_ARGS__); \
+		default: \
+			if (sparseTerms) return f<sparseWords>(__VA_ARGS__); \
+			return f<0>(__VA_ARGS__); \
+	}
+
+	///раздвигает результат compareLanes() на все биты каждой степени
+	static inline DegWord laneMask(DegWord cmp){
+		return (cmp >> (8*degreeBytes-1)) * firstLaneBits;
+	}
+
+	/**\details
+	Возвращает \a k-ю пару разреженного монома \a degrees (см. #sparseTerms): номер переменной (с 1) в старших 16 битах, степень - в младших.
+	Поэтому пары упорядочены по номерам переменных как числа, а пары одной переменной - по степеням.
+	*/
+	static inline uint32_t sparseTerm(const DegData *degrees, int k){
+		uint32_t term;
+		memcpy(&term, reinterpret_cast<const char*>(degrees)+sizeof(DegWord)+k*sizeof(term), sizeof(term));
+		return term;
+	}
+
+	///число переменных разреженного монома \a degrees
+	static inline int sparseCount(const DegData *degrees){
+		return int((getWord(degrees, 0)>>16) & 0xFFFF);
+	}
+
+	///возвращает \a i-ю степень (0 - суммарная) разреженного монома \a degrees; пара переменной ищется двоичным поиском
+	static inline int sparseDegreeAt(const DegData *degrees, int i){
+		if (!i) return totalDegree(degrees);
+		int from = 0, to = sparseCount(degrees);
+		while (from<to){
+			const int k = (from+to)/2;
+			const uint32_t term = sparseTerm(degrees, k);
+			if (int(term>>16)==i) return int(term & 0xFFFF);
+			if (int(term>>16)<i) from = k+1; else to = k;
+		}
+		return 0;
+	}
+
+	///сумма степеней переменных [\a from;\a to) разреженного монома \a degrees
+	static inline int64_t sparseBlockDegree(const DegData *degrees, int from, int to){
+		int64_t sum = 0;
+		for(int k = 0; k<sparseCount(degrees); ++k){
+			const uint32_t term = sparseTerm(degrees, k);
+			if (int(term>>16)>=from && int(term>>16)<to) sum += term & 0xFFFF;
+		}
+		return sum;
+	}
+
+	/**\details
+	Записывает в \a degrees разреженный моном из \a count пар \a terms (см. sparseTerm()) с суммарной степенью \a total и ключом порядка \a key,
+	вычисляя хеш и маску делимости.
+	\throws DegreeOverflow если пар больше, чем #sparseTerms
+	*/
+	static inline void setSparseTerms(DegData *degrees, const uint32_t *terms, int count, int total, DegWord key){
+		if (count>sparseTerms) throw DegreeOverflow("sparse monomial has more than " + std::to_string(sparseTerms) + " variables");
+		setWord(degrees, 0, DegWord(total) | DegWord(count)<<16);
+		char *pairs = reinterpret_cast<char*>(degrees)+sizeof(DegWord);
+		memcpy(pairs, terms, count*sizeof(uint32_t));
+		memset(pairs+count*sizeof(uint32_t), 0, (sparseTerms-count)*sizeof(uint32_t));
+		DegWord h = 0;
+		for(int k = 0; k<count; ++k)
+			h += DegWord(terms[k] & 0xFFFF)*hashMultipliers[terms[k]>>16];
+		setHash(degrees, h);
+		setOrderKey(degrees, key);
+		updateDivMask(degrees);
+	}
+
+	/**\details
+	Поэлементная операция над разреженными мономами: записывает в \a terms пары переменных, для которых степень \a op(e1, e2) положительна,
+	где e1 и e2 - степени переменной в \a degrees1 и \a degrees2 (0, если переменной в мономе нет), а в \a total - сумму этих степеней.
+	Возвращает число записанных пар или -1, если \a op вернула отрицательную степень. \a terms должен вмещать пары обоих мономов.
+	*/
+	template <class Op> static inline int sparseMerge(const DegData *degrees1, const DegData *degrees2, uint32_t *terms, int& total, Op op){
+		const int count1 = sparseCount(degrees1), count2 = sparseCount(degrees2);
+		int i = 0, j = 0, count = 0;
+		total = 0;
+		while (i<count1 || j<count2){
+			//номера переменных меньше 0xFFFF, поэтому закончившийся моном не мешает выбору наименьшей переменной
+			const uint32_t a = i<count1 ? sparseTerm(degrees1, i) : ~uint32_t(0);
+			const uint32_t b = j<count2 ? sparseTerm(degrees2, j) : ~uint32_t(0);
+			const uint32_t var = std::min(a>>16, b>>16);
+			int e1 = 0, e2 = 0;
+			if (a>>16==var){
+				e1 = int(a & 0xFFFF);
+				++i;
+			}
+			if (b>>16==var){
+				e2 = int(b & 0xFFFF);
+				++j;
+			}
+			const int e = op(e1, e2);
+			if (e<0) return -1;
+			if (e){
+				terms[count++] = var<<16 | uint32_t(e);
+				total += e;
+			}
+		}
+		return count;
+	}
+
+	///mul() для разреженных мономов
+	static inline void sparseMul(const DegData *degrees1, const DegData *degrees2, DegData *degreesres){
+		uint32_t terms[2*sparseMaxTerms];
+		int total;
+		const int count = sparseMerge(degrees1, degrees2, terms, total, [](int e1, int e2){return e1+e2;});
+		setSparseTerms(degreesres, terms, count, total, orderKey(degrees1)+orderKey(degrees2)-orderKeyOfOne);
+	}
+
+	///tryDiv() для разреженных мономов
+	static inline bool sparseTryDiv(const DegData *degrees1, const DegData *degrees2, DegData *degreesres){
+		if (getDivMask(degrees2) & ~getDivMask(degrees1)) return false;
+		uint32_t terms[2*sparseMaxTerms];
+		int total;
+		const int count = sparseMerge(degrees1, degrees2, terms, total, [](int e1, int e2){return e1-e2;});
+		if (count<0) return false;
+		setSparseTerms(degreesres, terms, count, total, orderKey(degrees1)-orderKey(degrees2)+orderKeyOfOne);
+		return true;
+	}
+
+	///НОК (при \a Lcm) или НОД разреженных мономов (см. lcm() и gcd())
+	template <bool Lcm> static inline void sparseExtreme(const DegData *degrees1, const DegData *degrees2, DegData *degreesres){
+		uint32_t terms[2*sparseMaxTerms];
+		int total, count;
+		if (Lcm) count = sparseMerge(degrees1, degrees2, terms, total, [](int e1, int e2){return std::max(e1, e2);});
+		else count = sparseMerge(degrees1, degrees2, terms, total, [](int e1, int e2){return std::min(e1, e2);});
+		const DegWord key = orderKeyPerVariable ? extremeOrderKey<Lcm>(degrees1, degrees2) | ((DegWord(total)<<(64-8*degreeBytes)) & orderKeyTotalMask) : 0;
+		setSparseTerms(degreesres, terms, count, total, key);
+		if (!orderKeyPerVariable) setOrderKey(degreesres, computeOrderKey(degreesres));
+	}
+
+	///divisibleBy() для разреженных мономов: каждая пара делителя должна найтись в \a degrees1 с не меньшей степенью
+	static inline bool sparseDivisibleBy(const DegData *degrees1, const DegData *degrees2){
+		if (getDivMask(degrees2) & ~getDivMask(degrees1)) return false;
+		const int count1 = sparseCount(degrees1), count2 = sparseCount(degrees2);
+		int i = 0;
+		for(int j = 0; j<count2; ++j){
+			const uint32_t b = sparseTerm(degrees2, j);
+			while (i<count1 && sparseTerm(degrees1, i)>>16 < b>>16) ++i;
+			if (i==count1) return false;
+			const uint32_t a = sparseTerm(degrees1, i);
+			if ((a^b)>>16 || a<b) return false;
+		}
+		return true;
+	}
+
+	///лексикографическое сравнение степеней переменных разреженных мономов (см. compareVariables())
+	static inline int sparseCompareLex(const DegData *degrees1, const DegData *degrees2){
+		const int count1 = sparseCount(degrees1), count2 = sparseCount(degrees2);
+		for(int k = 0; k<count1 && k<count2; ++k){
+			const uint32_t a = sparseTerm(degrees1, k), b = sparseTerm(degrees2, k);
+			if (a==b) continue;
+			//при разных переменных у монома с меньшей из них степень первой различающейся переменной положительна, а у другого - нулевая
+			if ((a^b)>>16) return a<b ? 1 : -1;
+			return a>b ? 1 : -1;
+		}
+		if (count1==count2) return 0;
+		return count1>count2 ? 1 : -1;
+	}
+
+	///обратно лексикографическое сравнение степеней переменных [\a from;\a to) разреженных мономов (см. compareDegRevLex())
+	static inline int sparseCompareRevLex(const DegData *degrees1, const DegData *degrees2, int from, int to){
+		int i = sparseCount(degrees1)-1, j = sparseCount(degrees2)-1;
+		while (i>=0 && int(sparseTerm(degrees1, i)>>16)>=to) --i;
+		while (j>=0 && int(sparseTerm(degrees2, j)>>16)>=to) --j;
+		for(;; --i, --j){
+			//пара 0 означает, что переменные блока закончились
+			const uint32_t a = i>=0 && int(sparseTerm(degrees1, i)>>16)>=from ? sparseTerm(degrees1, i) : 0;
+			const uint32_t b = j>=0 && int(sparseTerm(degrees2, j)>>16)>=from ? sparseTerm(degrees2, j) : 0;
+			if (a==b){
+				if (!a) return 0;
+				continue;
+			}
+			//большая пара - либо большая степень той же переменной, либо положительная степень более поздней переменной; оба случая дают меньший моном
+			return a<b ? 1 : -1;
+		}
+	}
+
+	///compareTo() для разреженных мономов после сравнения ключей порядка
+	template <Order O> static inline int sparseCompareTo(const DegData *degrees1, const DegData *degrees2){
+		if (O==lexOrder) return sparseCompareLex(degrees1, degrees2);
+		if (O==blklexOrder){
+			const int blocks[3] = {1, orderParam+1, theNumberOfVariables+1};
+			for(int b = 0; b<2; ++b){
+				const int64_t s1 = sparseBlockDegree(degrees1, blocks[b], blocks[b+1]), s2 = sparseBlockDegree(degrees2, blocks[b], blocks[b+1]);
+				if (s1!=s2) return s1>s2 ? 1 : -1;
+				const int res = sparseCompareRevLex(degrees1, degrees2, blocks[b], blocks[b+1]);
+				if (res) return res;
+			}
+			return 0;
+		}
+		const int deg1 = totalDegree(degrees1), deg2 = totalDegree(degrees2);
+		if (deg1!=deg2) return deg1>deg2 ? 1 : -1;
+		if (O==deglexOrder) return sparseCompareLex(degrees1, degrees2);
+		return sparseCompareRevLex(degrees1, degrees2, 1, theNumberOfVariables+1);
+	}
+
+	///возвращает \a i-ю степень (0 - суммарная) монома \a degrees, хранимую в типе \a Lane
+	template <class Lane> static inline int degreeAt(const DegData *degrees, int i){
+		Lane d;
+		memcpy(&d, degrees+i*sizeof(Lane), sizeof(d));
+		return d;
+	}
+
+	///записывает \a value в \a i-ю степень (0 - суммарная) монома \a degrees, хранимую в типе \a Lane
+	template <class Lane> static inline void setDegreeAt(DegData *degrees, int i, int value){
+		const Lane d = Lane(value);
+		memcpy(degrees+i*sizeof(Lane), &d, sizeof(d));
+	}
+
+	///возвращает \a i-ю степень (0 - суммарная) монома \a degrees при текущей ширине степеней
+	static inline int degreeAt(const DegData *degrees, int i){
+		if (sparseTerms) return sparseDegreeAt(degrees, i);
+		switch (degreeBytes){
+			case 1: return degreeAt<int8_t>(degrees, i);
+			case 2: return degreeAt<int16_t>(degrees, i);
+			default: return degreeAt<int32_t>(degrees, i);
+		}
+	}
+
+	///возвращает маску делимости монома \a degrees
+	static inline DivMask getDivMask(const DegData *degrees){
+		DivMask mask;
+		memcpy(&mask, reinterpret_cast<const char*>(degrees)+divMaskOffset, sizeof(mask));
+		return mask;
+	}
+
+	///записывает хеш \a h в данные монома \a degrees
+	static inline void setHash(DegData *degrees, DegWord h){
+		memcpy(reinterpret_cast<char*>(degrees)+hashOffset, &h, sizeof(h));
+	}
+
+	///вычисляет хеш монома \a degrees по его словам степеней (см. hash())
+	template <int Words> static inline DegWord computeHash(const DegData *degrees){
+		DegWord h = 0;
+		for(int w = 0; w<wordsOf<Words>(); ++w)
+			h += getWord(degrees, w)*hashMultipliers[w];
+		return h;
+	}
+
+	///записывает ключ порядка \a key в данные монома \a degrees
+	static inline void setOrderKey(DegData *degrees, DegWord key){
+		memcpy(reinterpret_cast<char*>(degrees)+orderKeyOffset, &key, sizeof(key));
+	}
+
+	///переставляет степени, хранимые в типе \a Lane, в слове \a word в обратном порядке
+	template <class Lane> static inline DegWord reverseLanes(DegWord word){
+		if (sizeof(Lane)==4) return (word<<32) | (word>>32);
+		word = __builtin_bswap64(word);
+		if (sizeof(Lane)==2) word = ((word>>8) & 0x00FF00FF00FF00FFull) | ((word & 0x00FF00FF00FF00FFull)<<8);
+		return word;
+	}
+
+	/**\details
+	Вычисляет ключ порядка монома \a degrees по его степеням, хранимым в типе \a Lane (см. orderKey()).
+	Если степени занимают одно слово, ключи lex, deglex и degrevlex получаются перестановкой степеней слова целиком
+	(обращением порядка степеней или сдвигом), иначе степени ключа собираются по одной.
+	*/
+	template <class Lane> static inline DegWord computeOrderKey(const DegData *degrees){
+		const int laneBits = 8*sizeof(Lane);
+		if (degreeWords==1 && orderKeyOrder!=blklexOrder){
+			const DegWord word = getWord(degrees, 0);
+			switch (orderKeyOrder){
+				case lexOrder: return (reverseLanes<Lane>(word)<<laneBits) & orderKeyMask;
+				case deglexOrder: return reverseLanes<Lane>(word) & orderKeyMask;
+				default:{
+					//дополнение степеней переменных; x_n попадает в степень сразу под суммарной, x_(n-1) - под ней и т.д.
+					const int usedBits = laneBits*(theNumberOfVariables+1);
+					const DegWord varLanes = (usedBits==64 ? ~DegWord(0) : (DegWord(1)<<usedBits)-1) & ~firstLaneBits;
+					const DegWord vars = ((laneLowBits*(firstLaneBits>>1)) & varLanes) - (word & varLanes);
+					const int shift = laneBits*(degsPerWord-2-theNumberOfVariables);
+					const DegWord moved = shift>=0 ? vars<<shift : vars>>-shift;
+					return ((word & firstLaneBits)<<(64-laneBits)) | (moved & orderKeyMask);
+				}
+			}
+		}
+		DegWord key = 0;
+		for(size_t j = 0; j<orderKeyLanes.size(); ++j){
+			const OrderKeyLane& lane = orderKeyLanes[j];
+			DegWord value = 0;
+			for(int i = lane.from; i<lane.to; ++i)
+				value += degreeAt<Lane>(degrees, i);
+			if (lane.reversed) value = (firstLaneBits>>1)-value;
+			key |= value << (64-laneBits*(j+1));
+		}
+		return key;
+	}
+
+	///вычисляет ключ порядка монома \a degrees по его степеням (см. orderKey())
+	static inline DegWord computeOrderKey(const DegData *degrees){
+		if (sparseTerms){
+			DegWord key = 0;
+			for(size_t j = 0; j<orderKeyLanes.size(); ++j){
+				const OrderKeyLane& lane = orderKeyLanes[j];
+				DegWord value = lane.from ? sparseBlockDegree(degrees, lane.from, lane.to) : totalDegree(degrees);
+				if (lane.reversed) value = (firstLaneBits>>1)-value;
+				key |= value << (64-8*degreeBytes*(j+1));
+			}
+			return key;
+		}
+		switch (degreeBytes){
+			case 1: return computeOrderKey<int8_t>(degrees);
+			case 2: return computeOrderKey<int16_t>(degrees);
+			default: return computeOrderKey<int32_t>(degrees);
+		}
+	}
+
+	///пересчитывает маску делимости монома \a degrees по степеням переменных, хранимым в типе \a Lane
+	template <class Lane> static inline void updateDivMask(DegData *degrees){
+		DivMask mask = 0;
+		for(int i = 0; i<divMaskVariables; ++i){
+			const int bits = std::min<int>(std::max<int>(degreeAt<Lane>(degrees, i+1), 0), divMaskBitsPerVariable);
+			mask |= DivMask(((uint64_t(1)<<bits)-1)<<(i*divMaskBitsPerVariable));
+		}
+		memcpy(reinterpret_cast<char*>(degrees)+divMaskOffset, &mask, sizeof(mask));
+	}
+
+	/**\details
+	Пересчитывает маску делимости монома \a degrees по степеням переменных.
+	Маска разреженного монома - множество его переменных, свёрнутое по модулю числа битов маски.
+	*/
+	static inline void updateDivMask(DegData *degrees){
+		if (sparseTerms){
+			DivMask mask = 0;
+			for(int k = 0; k<sparseCount(degrees); ++k)
+				mask |= DivMask(1)<<(((sparseTerm(degrees, k)>>16)-1)%(8*sizeof(DivMask)));
+			memcpy(reinterpret_cast<char*>(degrees)+divMaskOffset, &mask, sizeof(mask));
+			return;
+		}
+		switch (degreeBytes){
+			case 1: updateDivMask<int8_t>(degrees); break;
+			case 2: updateDivMask<int16_t>(degrees); break;
+			default: updateDivMask<int32_t>(degrees); break;
+		}
+	}
 
 	///Инициализирует данные монома \a degrees значениями по умолчанию (нулевой степенью)
-	static inline void initmondefault(Deg *degrees){
-		for(int i = 0; i<theNumberOfVariables+1; ++i)
-			degrees[i] = 0;
+	template <int Words> static inline void initmondefault(DegData *degrees){
+		for(int w = 0; w<wordsOf<Words>(); ++w)
+			setWord(degrees, w, 0);
+		setHash(degrees, 0);
+		setOrderKey(degrees, orderKeyOfOne);
+		updateDivMask(degrees);
+	}
+
+	///initmondefault() для текущего числа слов степеней (см. CMONOMIAL_DISPATCH_WORDS)
+	static inline void initmondefault(DegData *degrees){
+		CMONOMIAL_DISPATCH_WORDS(initmondefault, degrees)
 	}
 
 	/**Инициализирует моном по набору степеней переменных
 	Инициализирует данные монома \a degrees значениями по заданному набору степеней переменных \a ptr
 	и вычисляет суммарную степень
 	*/
-	static inline void initmonfromptr(Deg *degrees,const Deg *ptr){
+	static inline void initmonfromptr(DegData *degrees,const Deg *ptr){
 		for(int i = 0; i<theNumberOfVariables; ++i)
-			degrees[i+1] = ptr[i];
+			if (ptr[i]<0 || ptr[i]>maxDegree) throw DegreeOverflow("monomial degree out of range: " + std::to_string(ptr[i]));
+		if (sparseTerms){
+			std::vector<uint32_t> terms;
+			int64_t total = 0;
+			for(int i = 0; i<theNumberOfVariables; ++i){
+				if (!ptr[i]) continue;
+				terms.push_back(uint32_t(i+1)<<16 | uint32_t(ptr[i]));
+				total += ptr[i];
+			}
+			if (total>maxDegree) throw DegreeOverflow("monomial degree out of range: " + std::to_string(total));
+			setSparseTerms(degrees, terms.data(), int(terms.size()), int(total), 0);
+			setOrderKey(degrees, computeOrderKey(degrees));
+			return;
+		}
+		//после округления 3 слов до 4 дополнение нулями может занимать два последних слова
+		for(int w = (theNumberOfVariables+1)/degsPerWord; w<degreeWords; ++w)
+			setWord(degrees, w, 0);
+		for(int i = 0; i<theNumberOfVariables; ++i){
+			switch (degreeBytes){
+				case 1: setDegreeAt<int8_t>(degrees, i+1, ptr[i]); break;
+				case 2: setDegreeAt<int16_t>(degrees, i+1, ptr[i]); break;
+				default: setDegreeAt<int32_t>(degrees, i+1, ptr[i]); break;
+			}
+		}
 		setDegree(degrees);
 	}
 
 	///Инициализирует моном \a degrees по заданному моному \a dgoriginal
-	static inline void initmonfrom(Deg *degrees,const Deg *dgoriginal){
-		for(int i = 0; i<theNumberOfVariables+1; ++i)
-			degrees[i] = dgoriginal[i];
+	template <int Words> static inline void initmonfrom(DegData *degrees,const DegData *dgoriginal){
+		for(int w = 0; w<wordsOf<Words>(); ++w)
+			setWord(degrees, w, getWord(dgoriginal, w));
+		setHash(degrees, hash(dgoriginal));
+		setOrderKey(degrees, orderKey(dgoriginal));
+		const DivMask mask = getDivMask(dgoriginal);
+		memcpy(reinterpret_cast<char*>(degrees)+divMaskOffset, &mask, sizeof(mask));
+	}
+
+	///initmonfrom() для текущего числа слов степеней (см. CMONOMIAL_DISPATCH_WORDS)
+	static inline void initmonfrom(DegData *degrees,const DegData *dgoriginal){
+		CMONOMIAL_DISPATCH_WORDS(initmonfrom, degrees, dgoriginal)
 	}
 
-	///корректиует моном \a degrees - устанавливает суммарную степень равной сумме степеней переменных
-	static inline void setDegree(Deg *degrees)
+	///реализация setDegree() для степеней, хранимых в типе \a Lane
+	template <class Lane> static inline void setDegree(DegData *degrees)
 	{
-		degrees[0]=0;
+		int64_t total = 0;
 		for(int i =1; i< theNumberOfVariables+1; ++i)
-			degrees[0]+=degrees[i];
+			total+=degreeAt<Lane>(degrees, i);
+		if (total>maxDegree) throw DegreeOverflow("monomial degree out of range: " + std::to_string(total));
+		setDegreeAt<Lane>(degrees, 0, int(total));
+		setHash(degrees, computeHash<0>(degrees));
+		setOrderKey(degrees, computeOrderKey<Lane>(degrees));
+		updateDivMask<Lane>(degrees);
+	}
+
+	///корректиует моном \a degrees - устанавливает суммарную степень равной сумме степеней переменных и пересчитывает хеш, ключ порядка и маску делимости
+	static inline void setDegree(DegData *degrees)
+	{
+		switch (degreeBytes){
+			case 1: setDegree<int8_t>(degrees); break;
+			case 2: setDegree<int16_t>(degrees); break;
+			default: setDegree<int32_t>(degrees); break;
+		}
+	}
+
+	///возвращает суммарную степень монома \a degrees
+	static inline int totalDegree(const DegData *degrees){
+		return int(getWord(degrees, 0) & firstLaneBits);
+	}
+
+	/**\details
+	Устанавливает суммарную степень монома \a degrees равной сумме степеней переменных и пересчитывает хеш, ключ порядка и маску делимости.
+	Степени каждого слова складываются одним умножением на #laneLowBits: старшая степень произведения равна сумме всех степеней слова.
+	Это верно, только если все частичные суммы помещаются в степень, поэтому функция применима лишь к мономам,
+	суммарная степень которых заведомо не больше #maxDegree (НОД и НОК после проверки checkOverflowInLcm()).
+	Если ключ порядка состоит из степеней отдельных переменных (#orderKeyPerVariable), то его часть без суммарной степени
+	передаётся в \a variablesKey (см. extremeOrderKey()), иначе ключ вычисляется заново по степеням.
+	*/
+	template <int Words> static inline void setTotalDegree(DegData *degrees, DegWord variablesKey){
+		const int laneShift = 64-8*degreeBytes;
+		DegWord total = 0;
+		for(int w = 0; w<wordsOf<Words>(); ++w){
+			DegWord word = getWord(degrees, w);
+			if (!w) word &= ~firstLaneBits;
+			total += (word*laneLowBits) >> laneShift;
+		}
+		setWord(degrees, 0, (getWord(degrees, 0) & ~firstLaneBits) | total);
+		setHash(degrees, computeHash<Words>(degrees));
+		setOrderKey(degrees, orderKeyPerVariable ? variablesKey | ((total<<(64-8*degreeBytes)) & orderKeyTotalMask) : computeOrderKey(degrees));
+		updateDivMask(degrees);
+	}
+
+	/**\details
+	Возвращает степени отдельных переменных в ключе порядка НОК (при \a Lcm) или НОД мономов \a degrees1 и \a degrees2.
+	Степень переменной в ключе НОК - наибольшая из степеней в ключах мономов, а дополненная степень - наименьшая; для НОД наоборот.
+	*/
+	template <bool Lcm> static inline DegWord extremeOrderKey(const DegData *degrees1, const DegData *degrees2){
+		const DegWord a = orderKey(degrees1), b = orderKey(degrees2);
+		const DegWord aNotLess = laneMask(compareLanes(a, b));
+		const DegWord larger = (a & aNotLess) | (b & ~aNotLess), smaller = (b & aNotLess) | (a & ~aNotLess);
+		return Lcm ? (larger & orderKeyForwardMask) | (smaller & orderKeyReversedMask) : (smaller & orderKeyForwardMask) | (larger & orderKeyReversedMask);
 	}
 
 	/** НОД мономов.
 	записывает в \a degreesres данные наибольшего общего делителя \a degrees1 и \a degrees2
 	*/
-	static inline void gcd (const Deg *degrees1, const Deg *degrees2, Deg *degreesres)
+	template <int Words> static inline void gcd(const DegData *degrees1, const DegData *degrees2, DegData *degreesres)
 	{
-		for(int i = 1; i<theNumberOfVariables+1; ++i)
-			degreesres[i]=std::min(degrees1[i],degrees2[i]);
-		setDegree(degreesres);
+		if (Words==sparseWords) return sparseExtreme<false>(degrees1, degrees2, degreesres);
+		const DegWord key = extremeOrderKey<false>(degrees1, degrees2);
+		for(int w = 0; w<wordsOf<Words>(); ++w){
+			const DegWord a = getWord(degrees1, w), b = getWord(degrees2, w);
+			const DegWord aNotLess = laneMask(compareLanes(a, b));
+			setWord(degreesres, w, (b & aNotLess) | (a & ~aNotLess));
+		}
+		setTotalDegree<Words>(degreesres, key);
+	}
+
+	///gcd() для текущего числа слов степеней (см. CMONOMIAL_DISPATCH_WORDS)
+	static inline void gcd(const DegData *degrees1, const DegData *degrees2, DegData *degreesres){
+		CMONOMIAL_DISPATCH_WORDS(gcd, degrees1, degrees2, degreesres)
 	}
 
-	static inline void checkOverflowInLcm(const Deg *degrees1, const Deg *degrees2)
+	static inline void checkOverflowInLcm(const DegData *degrees1, const DegData *degrees2)
 	{
-		if (int(degrees1[0]) + int(degrees2[0]) > MAX_DEGREE) throw std::runtime_error(std::string("possible degree overflow in monomial lcm: ") + toString(degrees1) + " * " + toString(degrees2));
+		if (int64_t(totalDegree(degrees1)) + totalDegree(degrees2) > maxDegree) throw DegreeOverflow(std::string("possible degree overflow in monomial lcm: ") + toString(degrees1) + " * " + toString(degrees2));
 	}
 	
 	/** НОК мономов.
 	записывает в \a degreesres данные наименьшего общего кратного \a degrees1 и \a degrees2
 	*/
-	static inline void lcm (const Deg *degrees1, const Deg *degrees2, Deg *degreesres)
+	template <int Words> static inline void lcm(const DegData *degrees1, const DegData *degrees2, DegData *degreesres)
 	{
 		checkOverflowInLcm(degrees1, degrees2);
-		for(int i = 1; i<theNumberOfVariables+1; ++i)
-			degreesres[i]=std::max(degrees1[i],degrees2[i]);
-		setDegree(degreesres);
+		if (Words==sparseWords) return sparseExtreme<true>(degrees1, degrees2, degreesres);
+		const DegWord key = extremeOrderKey<true>(degrees1, degrees2);
+		for(int w = 0; w<wordsOf<Words>(); ++w){
+			const DegWord a = getWord(degrees1, w), b = getWord(degrees2, w);
+			const DegWord aNotLess = laneMask(compareLanes(a, b));
+			setWord(degreesres, w, (a & aNotLess) | (b & ~aNotLess));
+		}
+		setTotalDegree<Words>(degreesres, key);
+	}
+
+	///lcm() для текущего числа слов степеней (см. CMONOMIAL_DISPATCH_WORDS)
+	static inline void lcm(const DegData *degrees1, const DegData *degrees2, DegData *degreesres){
+		CMONOMIAL_DISPATCH_WORDS(lcm, degrees1, degrees2, degreesres)
 	}
 
-	static inline void checkOverflowInMul(const Deg *degrees1, const Deg *degrees2)
+	static inline void checkOverflowInMul(const DegData *degrees1, const DegData *degrees2)
 	{
-		if (int(degrees1[0]) + int(degrees2[0]) > MAX_DEGREE) throw std::runtime_error(std::string("degree overflow in monomial multiplication: ") + toString(degrees1) + " * " + toString(degrees2));
+		if (int64_t(totalDegree(degrees1)) + totalDegree(degrees2) > maxDegree) throw DegreeOverflow(std::string("degree overflow in monomial multiplication: ") + toString(degrees1) + " * " + toString(degrees2));
 	}
 	
 	/** умножение мономов.
 	записывает в \a degreesres данные поризведения \a degrees1 и \a degrees2
 	*/
-	static inline void mul(const Deg *degrees1, const Deg *degrees2, Deg *degreesres){
+	template <int Words> static inline void mul(const DegData *degrees1, const DegData *degrees2, DegData *degreesres){
 		checkOverflowInMul(degrees1, degrees2);
-		for(int i = 0; i<theNumberOfVariables+1; ++i)
-			degreesres[i]=degrees1[i]+degrees2[i];
+		if (Words==sparseWords) return sparseMul(degrees1, degrees2, degreesres);
+		for(int w = 0; w<wordsOf<Words>(); ++w)
+			setWord(degreesres, w, getWord(degrees1, w)+getWord(degrees2, w));
+		setHash(degreesres, hash(degrees1)+hash(degrees2));
+		setOrderKey(degreesres, orderKey(degrees1)+orderKey(degrees2)-orderKeyOfOne);
+		updateDivMask(degreesres);
+	}
+
+	///mul() для текущего числа слов степеней (см. CMONOMIAL_DISPATCH_WORDS)
+	static inline void mul(const DegData *degrees1, const DegData *degrees2, DegData *degreesres){
+		CMONOMIAL_DISPATCH_WORDS(mul, degrees1, degrees2, degreesres)
 	}
 	
 	/** in-place доножение монома.
 	записывает в \a degrees1 данные поризведения \a degrees1 и \a degrees2
 	*/
-	static inline void mulby(Deg *degrees1, const Deg *degrees2){
+	template <int Words> static inline void mulby(DegData *degrees1, const DegData *degrees2){
 		checkOverflowInMul(degrees1, degrees2);
-		for(int i = 0; i<theNumberOfVariables+1; ++i)
-			degrees1[i]+=degrees2[i];
+		if (Words==sparseWords) return sparseMul(degrees1, degrees2, degrees1);
+		for(int w = 0; w<wordsOf<Words>(); ++w)
+			setWord(degrees1, w, getWord(degrees1, w)+getWord(degrees2, w));
+		setHash(degrees1, hash(degrees1)+hash(degrees2));
+		setOrderKey(degrees1, orderKey(degrees1)+orderKey(degrees2)-orderKeyOfOne);
+		updateDivMask(degrees1);
+	}
+
+	///mulby() для текущего числа слов степеней (см. CMONOMIAL_DISPATCH_WORDS)
+	static inline void mulby(DegData *degrees1, const DegData *degrees2){
+		CMONOMIAL_DISPATCH_WORDS(mulby, degrees1, degrees2)
 	}
 
 	/** попытка деления мономов.
 	записывает в \a degreesres данные результата деления \a degrees1 на \a degrees2.
 	Если деление невозможно возвращает false, а записанный в degreesres результат неопределён
 	*/
-	static inline bool tryDiv(const Deg *degrees1,const Deg *degrees2, Deg *degreesres){
-		for(int i = 0; i<theNumberOfVariables+1; ++i)
+	template <int Words> static inline bool tryDiv(const DegData *degrees1,const DegData *degrees2, DegData *degreesres){
+		if (Words==sparseWords) return sparseTryDiv(degrees1, degrees2, degreesres);
+		if (getDivMask(degrees2) & ~getDivMask(degrees1)) return false;
+		for(int w = 0; w<wordsOf<Words>(); ++w)
 		{
-			if ((degreesres[i]=degrees1[i]-degrees2[i]) < 0) return false;
+			const DegWord a = getWord(degrees1, w), b = getWord(degrees2, w);
+			if (compareLanes(a, b) != laneHighBits) return false;
+			setWord(degreesres, w, a-b);
 		}
+		setHash(degreesres, hash(degrees1)-hash(degrees2));
+		setOrderKey(degreesres, orderKey(degrees1)-orderKey(degrees2)+orderKeyOfOne);
+		updateDivMask(degreesres);
 		return true;
 	}
+
+	///tryDiv() для текущего числа слов степеней (см. CMONOMIAL_DISPATCH_WORDS)
+	static inline bool tryDiv(const DegData *degrees1,const DegData *degrees2, DegData *degreesres){
+		CMONOMIAL_DISPATCH_WORDS(tryDiv, degrees1, degrees2, degreesres)
+	}
 	
 	/** деление мономов.
 	записывает в \a degreesres данные результата деления \a degrees1 на \a degrees2.
 	Процедура требует, чтоб деление было возможно, иначе полученный результат будет некорректен
 	*/
-	static inline void div(const Deg *degrees1,const Deg *degrees2, Deg *degreesres){
-		for(int i = 0; i<theNumberOfVariables+1; ++i)
+	template <int Words> static inline void div(const DegData *degrees1,const DegData *degrees2, DegData *degreesres){
+		if (Words==sparseWords){
+			if (!sparseTryDiv(degrees1, degrees2, degreesres)) assert(!"monomial is not divisible");
+			return;
+		}
+		for(int w = 0; w<wordsOf<Words>(); ++w)
 		{
-			degreesres[i]=degrees1[i]-degrees2[i];
-			assert(degreesres[i]>=0);
+			const DegWord a = getWord(degrees1, w), b = getWord(degrees2, w);
+			assert(compareLanes(a, b) == laneHighBits);
+			setWord(degreesres, w, a-b);
 		}
+		setHash(degreesres, hash(degrees1)-hash(degrees2));
+		setOrderKey(degreesres, orderKey(degrees1)-orderKey(degrees2)+orderKeyOfOne);
+		updateDivMask(degreesres);
+	}
+
+	///div() для текущего числа слов степеней (см. CMONOMIAL_DISPATCH_WORDS)
+	static inline void div(const DegData *degrees1,const DegData *degrees2, DegData *degreesres){
+		CMONOMIAL_DISPATCH_WORDS(div, degrees1, degrees2, degreesres)
 	}
 	
 	/** in-place деление монома.
 	записывает в \a degrees1 данные результата деления \a degrees1 на \a degrees2.
 	Процедура требует, чтоб деление было возможно, иначе полученный результат будет некорректен
 	*/
-	static inline void divby(Deg *degrees1,const Deg *degrees2){
-		for(int i = 0; i<theNumberOfVariables+1; ++i)
+	template <int Words> static inline void divby(DegData *degrees1,const DegData *degrees2){
+		if (Words==sparseWords) return div<Words>(degrees1, degrees2, degrees1);
+		for(int w = 0; w<wordsOf<Words>(); ++w)
 		{
-			degrees1[i]-=degrees2[i];
-			assert(degrees1[i]>=0);
+			const DegWord a = getWord(degrees1, w), b = getWord(degrees2, w);
+			assert(compareLanes(a, b) == laneHighBits);
+			setWord(degrees1, w, a-b);
 		}
+		setHash(degrees1, hash(degrees1)-hash(degrees2));
+		setOrderKey(degrees1, orderKey(degrees1)-orderKey(degrees2)+orderKeyOfOne);
+		updateDivMask(degrees1);
+	}
+
+	///divby() для текущего числа слов степеней (см. CMONOMIAL_DISPATCH_WORDS)
+	static inline void divby(DegData *degrees1,const DegData *degrees2){
+		CMONOMIAL_DISPATCH_WORDS(divby, degrees1, degrees2)
 	}
 
 	/**Сравнивает поднаборы monomFrom и monomTo степеней degrees1 и degrees2 по порядку degrevlex*/
-	static int compareDegRevLex(const Deg *degrees1, const Deg *degrees2, int monomFrom, int monomTo){
-		int s1 = 0, s2 = 0;
+	static int compareDegRevLex(const DegData *degrees1, const DegData *degrees2, int monomFrom, int monomTo){
+		int64_t s1 = 0, s2 = 0;
 		for (int i = monomFrom; i != monomTo; ++i){
-			s1 += degrees1[i];
-			s2 += degrees2[i];
+			s1 += degreeAt(degrees1, i);
+			s2 += degreeAt(degrees2, i);
 		}
-		int degdif = s1 - s2;
-		if (degdif>0) return 1;
-		if (degdif<0) return -1;
+		if (s1>s2) return 1;
+		if (s1<s2) return -1;
 		for (int i = monomTo -1; i >= monomFrom; --i) {
-			int dif = degrees1[i] - degrees2[i];
+			int dif = degreeAt(degrees1, i) - degreeAt(degrees2, i);
 			if (dif<0) return 1;//reversed
 			if (dif>0) return -1;
 		}
 		return 0;
 	}
 	
+	/**\details
+	Сравнивает степени переменных (без суммарной) мономов \a degrees1 и \a degrees2 лексикографически - по первой различающейся степени,
+	а при \a Reversed - обратно лексикографически: по последней различающейся степени, меньшая из которых даёт больший моном.
+	Различающиеся степени находятся по ненулевым битам XOR целых слов, что заменяет поэлементный цикл сравнением слов.
+	*/
+	template <bool Reversed, int Words> static inline int compareVariables(const DegData *degrees1, const DegData *degrees2){
+		for(int k = 0; k<wordsOf<Words>(); ++k){
+			const int w = Reversed ? wordsOf<Words>()-1-k : k;
+			const DegWord a = getWord(degrees1, w), b = getWord(degrees2, w);
+			DegWord dif = a ^ b;
+			if (!w) dif &= ~firstLaneBits;//суммарная степень не сравнивается
+			if (!dif) continue;
+			const int bit = Reversed ? 63-__builtin_clzll(dif) : __builtin_ctzll(dif);
+			const int shift = bit - bit%(8*degreeBytes);
+			//степени неотрицательны, поэтому их можно сравнивать как беззнаковые
+			const bool aGreater = ((a>>shift) & firstLaneBits) > ((b>>shift) & firstLaneBits);
+			return aGreater != Reversed ? 1 : -1;
+		}
+		return 0;
+	}
+
+	/**\details
+	Реализация compareTo() для порядка \a O и числа слов степеней \a Words.
+	Для порядка, под который построены ключи, сначала сравниваются ключи (см. orderKey()), и
+	к поэлементному сравнению степеней переходят, только если ключи совпали, но не определяют моном полностью.
+	*/
+	template <Order O, int Words> static inline int compareTo(const DegData *degrees1, const DegData *degrees2){
+		if (O==orderKeyOrder){
+			const DegWord key1 = orderKey(degrees1), key2 = orderKey(degrees2);
+			if (key1!=key2) return key1>key2 ? 1 : -1;
+			if (orderKeyComplete) return 0;
+		}
+		if (Words==sparseWords) return sparseCompareTo<O>(degrees1, degrees2);
+		if (O==lexOrder) return compareVariables<false, Words>(degrees1, degrees2);
+		if (O==blklexOrder){
+			int res1 = compareDegRevLex(degrees1, degrees2, 1, orderParam+1);
+			if (res1) return res1;
+			return compareDegRevLex(degrees1, degrees2, orderParam+1, theNumberOfVariables+1);
+		}
+		const DegWord deg1 = getWord(degrees1, 0) & firstLaneBits, deg2 = getWord(degrees2, 0) & firstLaneBits;
+		if (deg1!=deg2) return deg1>deg2 ? 1 : -1;
+		return compareVariables<O==degrevlexOrder, Words>(degrees1, degrees2);
+	}
+
+	///отношение порядка \a O на мономах (см. compareTo()) для текущего числа слов степеней
+	template <Order O> static inline int compareTo(const DegData *degrees1, const DegData *degrees2){
+		switch (degreeWords){
+			case 1: return compareTo<O, 1>(degrees1, degrees2);
+			case 2: return compareTo<O, 2>(degrees1, degrees2);
+			case 4: return compareTo<O, 4>(degrees1, degrees2);
+			default:
+				if (sparseTerms) return compareTo<O, sparseWords>(degrees1, degrees2);
+				return compareTo<O, 0>(degrees1, degrees2);
+		}
+	}
+
 	/**отношение порядка на мономах.
 	Сравнение происходит в соотвествии установленным на данный момент порядком.
+	Порядок проверяется при каждом вызове; там, где сравнений много, лучше один раз выбрать
+	инстанцированный для порядка вариант compareTo\<O\>() (см. runWithMonomialOrder()).
 	\retval число, определяющее результат сравнения:
 	\arg -1: \a degrees1 \< \a degrees2
 	\arg 1: \a degrees1 \> \a degrees2
 	\arg 0: \a degrees1 равно \a degrees2
 	*/
-	static inline int compareTo(const Deg *degrees1, const Deg *degrees2, Order orderToCompareWith){
+	static inline int compareTo(const DegData *degrees1, const DegData *degrees2, Order orderToCompareWith){
 		switch (orderToCompareWith){
-			case lexOrder:
-				{
-					for (int i = 1; i < theNumberOfVariables+1; ++i) {
-						int dif = degrees1[i] - degrees2[i];
-						if (dif>0) return 1;
-						if (dif<0) return -1;
-					}
-					break;
-				}
-			case deglexOrder:
-				{ 
-					int degdif = degrees1[0] - degrees2[0];
-					if (degdif>0) return 1;
-					if (degdif<0) return -1;
-					for (int i = 1; i < theNumberOfVariables+1; ++i) {
-						int dif = degrees1[i] - degrees2[i];
-						if (dif>0) return 1;
-						if (dif<0) return -1;
-					}
-					break;
-				}
-			case degrevlexOrder:
-				{
-					int degdif = degrees1[0] - degrees2[0];
-					if (degdif>0) return 1;
-					if (degdif<0) return -1;
-					for (int i = theNumberOfVariables; i > 0; --i) {
-						int dif = degrees1[i] - degrees2[i];
-						if (dif<0) return 1;//reversed
-						if (dif>0) return -1;
-					}
-					break;
-				}
-			case blklexOrder:
-				{
-					int res1 = compareDegRevLex(degrees1, degrees2, 1, orderParam+1);
-					if (res1) return res1;
-					return compareDegRevLex(degrees1, degrees2, orderParam+1, theNumberOfVariables+1);
-					break;
-				}
-			default:
-				{
-					throw std::logic_error("Unknown monomial order");
-				}
+			case lexOrder: return compareTo<lexOrder>(degrees1, degrees2);
+			case deglexOrder: return compareTo<deglexOrder>(degrees1, degrees2);
+			case degrevlexOrder: return compareTo<degrevlexOrder>(degrees1, degrees2);
+			case blklexOrder: return compareTo<blklexOrder>(degrees1, degrees2);
+			default: throw std::logic_error("Unknown monomial order");
 		}
-		return 0;
 	}
 
-	/**возвращает хеш-функцию на мономе \a degrees
-	хеш-функция выбрана так, чтоб минимизировать вероятность совпадения кодов для двух различных мономов \b небольшой степени с небольшим числом переменных.
-	Это достинается за счёт того, что информация о степенях "размазана" по всему числу.
-	Старшие биты более зависят почти только от степеней старших (первых) переменных, а младшие - от тех и других.
-	Таким образом, если 2 монома впервые отличаются отличаются в степени i-й переменной,
-	то, вероятно что значение хеш функции будет отличаться в битах, зависящих от перемеенных {1, ... , i}.
+	/**возвращает хеш монома \a degrees.
+	Хеш - сумма слов степеней, умноженных на случайные нечётные множители #hashMultipliers, по модулю 2^64.
+	Поскольку степени в словах складываются без переносов, хеш линеен по степеням: hash(a*b) = hash(a)+hash(b),
+	поэтому он хранится вместе с моном и при умножении и делении пересчитывается одним сложением или вычитанием.
+	Разные мономы из одного слова (до 7 переменных при 8-битных степенях) всегда имеют разные хеши,
+	а для нескольких слов совпадение хешей при случайных множителях маловероятно, в том числе для переставленных наборов степеней.
 	*/
-	static int hash(const Deg *degrees){
-		int res = 0;
-		//int res = 123;
-		for(int i = 0; i<theNumberOfVariables; i++){//на последний элемент можно не смотреть, поскольку он является функцией от предыдущих
-			res*=11;
-			res^=degrees[i];
-			//res = (res*11 + degrees[i])^142857151;
-		}
-		return res;
+	static inline DegWord hash(const DegData *degrees){
+		DegWord h;
+		memcpy(&h, reinterpret_cast<const char*>(degrees)+hashOffset, sizeof(h));
+		return h;
+	}
+
+	/**\details
+	Возвращает ключ порядка монома \a degrees: слово, в котором степени, определяющие порядок #orderKeyOrder,
+	упакованы по убыванию значимости (см. setupOrderKey()). Если ключ одного монома больше ключа другого,
+	то и моном больше; при равных ключах мономы равны, если #orderKeyComplete, а иначе их нужно сравнить по степеням.
+	Ключ аффинен по степеням, поэтому хранится вместе с моном и при умножении и делении пересчитывается сложением.
+	*/
+	static inline DegWord orderKey(const DegData *degrees){
+		DegWord key;
+		memcpy(&key, reinterpret_cast<const char*>(degrees)+orderKeyOffset, sizeof(key));
+		return key;
 	}
 
 	/**сравнение мономов на равенство.
 	Сравнение на равенство может оказаться эффективнее вызова compareTo(), поскольку понятие равенства не зависит от порядка и проще проверяется.
 	*/
-	static bool isEqual(const Deg *degrees1, const Deg *degrees2)
+	template <int Words> static inline bool isEqual(const DegData *degrees1, const DegData *degrees2)
 	{
 		//return memcmp(degrees1,degrees2,(1+theNumberOfVariables*sizeof(Deg)))==0; //странно, это оказалось медленнее
-		for(int i = 0; i<=theNumberOfVariables; ++i)//на последний элемент можно не смотреть, поскольку он является функцией от предыдущих
-			if (degrees1[i]!=degrees2[i]) return false;
+		for(int w = 0; w<wordsOf<Words>(); ++w)
+			if (getWord(degrees1, w)!=getWord(degrees2, w)) return false;
 		return true;
 	}
 
-	///Проверка на возможность деления
-	static bool divisibleBy(const Deg *degrees1,const Deg *degrees2)
+	///isEqual() для текущего числа слов степеней (см. CMONOMIAL_DISPATCH_WORDS)
+	static inline bool isEqual(const DegData *degrees1, const DegData *degrees2){
+		CMONOMIAL_DISPATCH_WORDS(isEqual, degrees1, degrees2)
+	}
+
+	///Проверка на возможность деления; сначала проверяются маски делимости
+	template <int Words> static inline bool divisibleBy(const DegData *degrees1,const DegData *degrees2)
 	{
-		for(int i = 0; i<theNumberOfVariables+1; ++i)
-			if(degrees1[i] < degrees2[i])
+		if (Words==sparseWords) return sparseDivisibleBy(degrees1, degrees2);
+		if (getDivMask(degrees2) & ~getDivMask(degrees1)) return false;
+		for(int w = 0; w<wordsOf<Words>(); ++w)
+			if(compareLanes(getWord(degrees1, w), getWord(degrees2, w)) != laneHighBits)
 				return false;
 		return true;
 	}  
@@ -306,24 +1053,34 @@ class CMonomialBase{
 	\param names соответствие между индексами и текстовыми именами переменных.
 	Если передан нулевой указатель (по умолчанию), используются стандартные имена x1 .. xN
 	*/
-	static std::string toString(const Deg *degrees, ParserVarNames* names=0){
+	static std::string toString(const DegData *degrees, ParserVarNames* names=0){
 		std::ostringstream out;
 		bool was = false;
 		for(int i = 1; i<theNumberOfVariables+1; ++i){									
-			if(degrees[i]>0){
+			const int d = degreeAt(degrees, i);
+			if(d>0){
 				if(was)	out<<"*";
 				out<<varName(i, names);
-				if(degrees[i]>1){
-					out<<"^"<<int(degrees[i]);
+				if(d>1){
+					out<<"^"<<d;
 				}
 				was = true;
 			}
 		}
 		return out.str();
 	}
+
+	///divisibleBy() для текущего числа слов степеней (см. CMONOMIAL_DISPATCH_WORDS)
+	static inline bool divisibleBy(const DegData *degrees1,const DegData *degrees2){
+		CMONOMIAL_DISPATCH_WORDS(divisibleBy, degrees1, degrees2)
+	}
   public:	
 	static std::string varName(int varIdxFrom1, ParserVarNames* names);
+	///таблица мономов хранит, хеширует и перемножает данные мономов напрямую
+	friend class MonomialTable;
 };
+//макрос нужен только внутри CMonomialBase
+#undef CMONOMIAL_DISPATCH_WORDS
 
 /** хранит данные монома в памяти, выделенной отдельно.
 В качестве менеджера памяти используется MemoryManager.
@@ -335,12 +1092,12 @@ class MonomialExternalPlacing{
 	MonomialExternalPlacing(const MonomialExternalPlacing&);//запрет на явное копирование класса
 	void operator=(const MonomialExternalPlacing&);//запрет на явное копирование класса
   protected:
-	typedef CMonomialBase::Deg Deg;
+	typedef CMonomialBase::DegData DegData;
 	///указатель на внешнюю память для хранения данных монома.
-	Deg* degrees;
+	DegData* degrees;
 
 	MonomialExternalPlacing(){
-		degrees = (Deg*)globalF4MPI::MonomialAllocator.getMem();
+		degrees = (DegData*)globalF4MPI::MonomialAllocator.getMem();
 		//degrees = new Deg[CMonomialBase::theNumberOfVariables+1];
 	}
 
@@ -360,20 +1117,20 @@ class MonomialExternalPlacing{
 /** хранит данные монома в памяти по адресу this.
 Объекты этого класса не создаются, не копируются и не удаляются,
 но в указатель на этот тип преобразуются указатели на реально выделенную внешнюю память
-(это делается в классе PODvecSize).
+(это делается в таблице мономов MonomialTable).
 */
 class MonomialInternalPlacing{
 	MonomialInternalPlacing();//запрет на явное создание переменной класса
 	MonomialInternalPlacing(const MonomialInternalPlacing&);//запрет на явное копирование класса
 	void operator=(const MonomialInternalPlacing&);
   protected:
-	typedef CMonomialBase::Deg Deg;
+	typedef CMonomialBase::DegData DegData;
 	/**\details
 	массив "указывающий" на данные монома; 
 	его адрес как раз совпадает с this (началом объекта POD-типа), реальный размер выделенной памяти равен
 	CMonomialBase::degreessize, но за это отвечает процедура, преобразовавшая указатель на память в указатель на MonomialInternalPlacing.
 	*/
-	Deg degrees[2];//реальный размер массива равен theNumberOfVariables+1
+	DegData degrees[2];//реальный размер массива равен CMonomialBase::degreessize
   public:
 	static int realSize(){
 		return CMonomialBase::degreessize;
@@ -388,7 +1145,7 @@ template <class Placing> class MonomialWithPlacing;
 typedef MonomialWithPlacing<MonomialExternalPlacing> CMonomial;
 
 /**Представление монома в многочлене.
-Переменная этого типа сущетствует \b только, как элемент контейнера PODvecSize<CInternalMonomial>, который и выделил для неё память. В остальных местах используются только указатели/ссылки на неё.
+Переменная этого типа сущетствует \b только, как элемент таблицы мономов MonomialTable, которая и выделила для неё память. В остальных местах используются только указатели/ссылки на неё.
 */
 typedef MonomialWithPlacing<MonomialInternalPlacing> CInternalMonomial;
 /**Реализация интерфейса монома.
@@ -444,13 +1201,13 @@ public:
 	///возвращает суммарную степень монома
 	int getDegree()const
 	{
-		return degrees[0];
+		return totalDegree(degrees);
 	}
 
 	///возвращает  степень переменной i-й переменной
 	int getDegree(int i) const
 	{
-		return degrees[i+1];
+		return degreeAt(degrees, i+1);
 	}
 
 	///возвращает НОД 2х мономов
@@ -513,8 +1270,18 @@ public:
 		return compareTo(monomialToCompare, CMonomialBase::order);
 	}
 
-	///возвращает хеш-код монома
-	int hash() const {
+	///сравнение по порядку \a O, выбранному при компиляции (см. runWithMonomialOrder())
+	template <Order O, class Placing2> inline int compareByOrder(const MonomialWithPlacing<Placing2>& monomialToCompare)const{
+		return CMonomialBase::compareTo<O>(degrees, monomialToCompare.degrees);
+	}
+
+	///возвращает ключ порядка монома (см. CMonomialBase::orderKey())
+	DegWord orderKey() const {
+		return CMonomialBase::orderKey(degrees);
+	}
+
+	///возвращает хеш-код монома (см. CMonomialBase::hash())
+	size_t hash() const {
 		return CMonomialBase::hash(degrees);
 	}
 
@@ -542,6 +1309,12 @@ public:
 		return CMonomialBase::divisibleBy(degrees,m.degrees);
 	}  
 
+	///возвращает маску делимости монома (см. CMonomialBase::DivMask)
+	DivMask divMask() const
+	{
+		return getDivMask(degrees);
+	}
+
 	/**возвращает строку, содержащую текстовое представление монома.
 	\param names соответствие между индексами и текстовыми именами переменных.
 	Если передан нулевой указатель (по умолчанию), используются стандартные имена x1 .. xN
@@ -585,5 +1358,19 @@ public:
 возможные значения: <tt>"lex", "deglex", "degrevlex"</tt>.
 */
 const std::string getMonomialOrderName(CMonomialBase::Order orderID);
+/**\details
+Вызывает Kernel\<O\>::run(args...) для текущего порядка на мономах O.
+Позволяет выбрать порядок один раз на всю операцию (например, сортировку), а не при каждом сравнении мономов.
+*/
+template <template <CMonomialBase::Order> class Kernel, typename... Args>
+void runWithMonomialOrder(Args&&... args){
+	switch(CMonomialBase::getOrder()){
+		case CMonomialBase::lexOrder: Kernel<CMonomialBase::lexOrder>::run(args...); return;
+		case CMonomialBase::deglexOrder: Kernel<CMonomialBase::deglexOrder>::run(args...); return;
+		case CMonomialBase::degrevlexOrder: Kernel<CMonomialBase::degrevlexOrder>::run(args...); return;
+		case CMonomialBase::blklexOrder: Kernel<CMonomialBase::blklexOrder>::run(args...); return;
+		default: throw std::logic_error("Unknown monomial order");
+	}
+}
 } //namespace F4MPI
 #endif
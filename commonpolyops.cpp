@@ -1,5 +1,8 @@
 #include "commonpolyops.h"
 #include "reducebyset.h"
+#include "threadpool.h"
+
+#include <exception>
 using namespace std;
 namespace F4MPI
 {
@@ -13,22 +16,14 @@ void Normalize(PolynomSet& polys){
 	}
 }
 
-///Возвращает S-пару, составленную из \a p1 и \a p2
-SPair MakeSPair(const CPolynomial& p1, const CPolynomial& p2)
-{
-	if(p1.compareTo(p2)<0)
-		return SPair(p1, p2);
-	return SPair(p2, p1);
-}
-
-void GetBasisTops(const PolynomSet &basis, vector<CMonomial>& basisTops)
+///Добавляет в \a basisTops старшие мономы многочленов \a basis, сопоставляя им номера многочленов
+void GetBasisTops(const PolynomSet &basis, DivisorIndex& basisTops)
 {
-	for(PolynomSet::const_iterator i = basis.begin();i!=basis.end();++i)
+	for(int i = 0; i<int(basis.size()); i++)
 	{
-		if (!i->empty())
+		if (!basis[i].empty())
 		{
-			CMonomial top = i->HM();
-			basisTops.push_back(top);
+			basisTops.insert(basis[i].getMonID(0), i);
 		}
 	}
 }
@@ -63,52 +58,166 @@ void Unique(PolynomSet& polys)
 	polys.resize(unique(polys.begin(), polys.end())-polys.begin());
 }
 
+namespace{
+///число мономов фронта препроцессинга в одной задаче пула потоков
+const int frontierPerTask=64;
+
+/**строки препроцессинга для отрезка фронта, найденные одной задачей.
+Мономы, которых ещё нет в таблице мономов, не добавляются в неё из задачи:
+вместо номера записывается noMonomial, а данные монома - в missing в порядке их появления.
+*/
+struct FrontierRows{
+	///номер препроцессора для каждого монома отрезка или -1
+	vector<int> reducers;
+	///множитель каждой найденной строки
+	vector<MonomialID> multipliers;
+	///мономы найденных строк подряд
+	vector<MonomialID> mons;
+	///данные отсутствующих в таблице множителей и мономов строк
+	vector<CMonomialBase::DegData> missing;
+	///исключение (например, DegreeOverflow), возникшее в задаче
+	exception_ptr failure;
+};
+}
+
 /**реализация препроцессинга (см теоретическую документацию)
 \param polys множество многочленов, которое будет редуцироваться.
 В результате препроцессинга к нему добавляются новые многочлены.
 \param reducers множество возможных многочленов-препроцессоров.
 Должно быть предварительно осортировано в соответствии с критерием оптимальности для использования в препроцессинге.
 Более оптимаотные препроцессорв должнв стоять в начале.
+\param pool пул потоков для поиска препроцессоров и домножения их на мономы.
+\param monomials рабочие множества мономов, сохраняемые между вызовами; если не заданы, создаются на время вызова.
+
+Мономы обрабатываются фронтами: все ещё не обработанные мономы, затем появившиеся в добавленных для них строках, и т.д.
+Препроцессоры и мономы строк фронта ищутся параллельно, а новые мономы добавляются в таблицу мономов
+и строки - в \a polys последовательно в порядке фронта, поэтому результат совпадает с поочерёдной обработкой мономов
+при любом числе потоков.
 */
-void Preprocess (PolynomSet& polys, PolynomSet& reducers)
+void Preprocess (PolynomSet& polys, PolynomSet& reducers, ThreadPool* pool, PreprocessMonomials* monomials)
 {
 	//MEASURE_TIME_IN_BLOCK("Preprocess");
-	MonomialMap processed;
-	MonomialMap monsToProcess;
+	MonomialTable& table=globalF4MPI::InternedMonomials;
+	PreprocessMonomials ownMonomials;
+	if (!monomials) monomials=&ownMonomials;
+	MonomialMap& processed=monomials->processed;
+	MonomialMap& monsToProcess=monomials->toProcess;
+	processed.clear();
+	monsToProcess.clear();
+	//все мономы исходных многочленов попадут в оба множества
+	size_t terms=0;
+	for(const auto& p: polys) terms+=p.size();
+	processed.reserve(terms);
+	monsToProcess.reserve(terms);
 	{
 		//MEASURE_TIME_IN_BLOCK("MonomialsOf");
 		MonomialsOf (monsToProcess, polys);	
 	}
-	
-	CMonomial mon, mulby, HMR;	
+	//старшие мономы исходных многочленов не требуют препроцессоров: ведущей станет одна из строк с таким старшим мономом
+	for(const auto& p: polys)
+	{
+		monsToProcess.erase(p.getMonID(0));
+		processed.storeMonomial(p.getMonID(0));
+	}
 
 	{
 		//MEASURE_TIME_IN_BLOCK("Unique");
 		Unique(reducers);
 	}
+	//старшие мономы препроцессоров с их номерами: из нескольких делителей выбирается первый по порядку препроцессор
+	DivisorIndex reducerHeads;
+	for(int i = 0; i<int(reducers.size()); i++)
+	{
+		reducerHeads.insert(reducers[i].getMonID(0), i);
+	}
 
+	const size_t degreessize=CMonomialBase::degreessize;
+	vector<MonomialID> frontier;
+	vector<FrontierRows> chunks;
 	while(!monsToProcess.empty())
 	{			
-		mon = monsToProcess.selectMonoimial();
-		monsToProcess.erase(mon);
-				
-		processed.storeMonomial(mon);
-
-		for(const auto& reducer: reducers)
-		{			
-			HMR = reducer.HM();
-			if(mon.tryDivide(HMR, mulby))
+		frontier.clear();
+		while(!monsToProcess.empty())
+		{
+			const MonomialID monID = monsToProcess.selectMonomialID();
+			monsToProcess.erase(monID);
+			processed.storeMonomial(monID);
+			frontier.push_back(monID);
+		}
+		const int tasks=int((frontier.size()+frontierPerTask-1)/frontierPerTask);
+		chunks.resize(max<size_t>(chunks.size(),tasks));
+		ThreadPool::Task task=[&](int t){
+			FrontierRows& chunk=chunks[t];
+			chunk.reducers.clear();
+			chunk.multipliers.clear();
+			chunk.mons.clear();
+			chunk.missing.clear();
+			chunk.failure=nullptr;
+			try{
+				vector<CMonomialBase::DegData> multiplier(degreessize), product(degreessize);
+				const size_t last=min(frontier.size(),size_t(t+1)*frontierPerTask);
+				for(size_t k=size_t(t)*frontierPerTask; k<last; ++k)
+				{
+					const int reducer=reducerHeads.minimalDivisor(table.get(frontier[k]));
+					chunk.reducers.push_back(reducer);
+					if (reducer<0) continue;
+					const CPolynomial& r=reducers[reducer];
+					const MonomialID by=table.findQuotient(frontier[k],r.getMonID(0),&multiplier[0]);
+					chunk.multipliers.push_back(by);
+					if (by==MonomialTable::noMonomial) chunk.missing.insert(chunk.missing.end(),multiplier.begin(),multiplier.end());
+					for(int i=0; i<int(r.size()); ++i)
+					{
+						const MonomialID m = by==MonomialTable::noMonomial ? table.findProduct(&multiplier[0],r.getMonID(i),&product[0]) : table.findProduct(by,r.getMonID(i),&product[0]);
+						chunk.mons.push_back(m);
+						if (m==MonomialTable::noMonomial) chunk.missing.insert(chunk.missing.end(),product.begin(),product.end());
+					}
+				}
+			}catch(...){
+				chunk.failure=current_exception();
+			}
+		};
+		if (pool && tasks>1){
+			pool->parallelFor(tasks,task);
+		}else{
+			for (int t=0;t<tasks;++t) task(t);
+		}
+		for(int t=0; t<tasks; ++t)
+		{
+			const FrontierRows& chunk=chunks[t];
+			if (chunk.failure) rethrow_exception(chunk.failure);
+			const CMonomialBase::DegData* missing=chunk.missing.data();
+			const MonomialID* mons=chunk.mons.data();
+			const MonomialID* multiplier=chunk.multipliers.data();
+			for(int reducer: chunk.reducers)
 			{
-				polys.push_back(reducer);
-				polys.back()*=mulby;				
+				if (reducer<0) continue;
+				//недостающие множитель и мономы добавляются в таблицу в том же порядке, что и при обработке по одному моному
+				if (*multiplier++==MonomialTable::noMonomial)
+				{
+					table.intern(missing);
+					missing+=degreessize;
+				}
+				const CPolynomial& r=reducers[reducer];
+				polys.emplace_back();
+				CPolynomial& row=polys.back();
+				row.resize(r.size());
+				for(int i=0; i<int(r.size()); ++i)
+				{
+					MonomialID m=*mons++;
+					if (m==MonomialTable::noMonomial)
+					{
+						m=table.intern(missing);
+						missing+=degreessize;
+					}
+					row.getMonID(i)=m;
+					row.getCoeff(i)=r.getCoeff(i);
+				}
 				{
 					//MEASURE_TIME_IN_BLOCK("storeNotProcessedCMonomials");
-					storeNotProcessedMonomialsFromPoly(monsToProcess, processed, polys.back());
+					storeNotProcessedMonomialsFromPoly(monsToProcess, processed, row);
 				}
-				break;
 			}
-			
-		}		
+		}
 	}		
 }
 
@@ -138,23 +247,20 @@ void AutoReduceBasis(PolynomSet& basis, const F4AlgData* f4options){
 	PolynomSet minimalBasis;
 	vector<bool> Mark;
 	int Size = 0;
-	CMonomial HMf;
+	//старшие мономы отмеченных элементов minimalBasis с их номерами
+	DivisorIndex minimalHeads;
+	vector<int> removed;
 	for(int i = 0; i<int(basis.size()); i++)
 	{
-		HMf = basis[i].HM();		
-		for(int j = 0; j<int(minimalBasis.size()); j++)if(Mark[j]){
-			if(minimalBasis[j].HM().divisibleBy(HMf)){
-				Mark[j] = false, Size--;
-			}
-		}
-		bool Condition = true;
-		for(int j = 0; Condition && j<int(minimalBasis.size()); j++)if(Mark[j]){
-			if(HMf.divisibleBy(minimalBasis[j].HM())){
-				Condition = false;
-			}
+		const auto& HMf = basis[i].HM();
+		removed.clear();
+		minimalHeads.removeMultiples(HMf, removed);
+		for(int j: removed){
+			Mark[j] = false, Size--;
 		}
-		if(Condition)
+		if(!minimalHeads.hasDivisor(HMf))
 		{
+			minimalHeads.insert(basis[i].getMonID(0), int(minimalBasis.size()));
 			minimalBasis.push_back(basis[i]);		
 			Mark.push_back(true);
 			Size++;
@@ -174,9 +280,9 @@ void AutoReduceBasis(PolynomSet& basis, const F4AlgData* f4options){
 		minimalBasis[i] = reducers[i];
 	}
 	
-	Preprocess(minimalBasis, reducers);
+	Preprocess(minimalBasis, reducers, f4options->threadPool.get());
 	CMatrix matrix;
-	polyToMatrix(minimalBasis,matrix);
+	polyToMatrix(minimalBasis,matrix,f4options->threadPool.get());
 	matrix.toDiagonalNormalForm(f4options);
 	PolynomSet reducedPolys;
 	MonomialMap empty;
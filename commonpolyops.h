@@ -1,10 +1,10 @@
 #pragma once
 #include "outputroutines.h"
 #include "conversions.h"
+#include "divisorindex.h"
 
 namespace F4MPI{
 void Normalize(PolynomSet& polys);
-SPair MakeSPair(const CPolynomial& p1, const CPolynomial& p2);
 
 /**
 Удаляет из вектора неотмеченныые элементы.
@@ -52,8 +52,24 @@ bool CheckMonIsDivisibleBySome(const CMonomial& mon, const Dividers& dividers)
 	return false;
 }
 
-void GetBasisTops(const PolynomSet &basis, std::vector<CMonomial>& basisTops);
-void Preprocess (PolynomSet& polys, PolynomSet& reducers);
+///CheckMonIsDivisibleBySome() для делителей, собранных в индекс делимости
+inline bool CheckMonIsDivisibleBySome(const CMonomial& mon, const DivisorIndex& dividers)
+{
+	return dividers.hasDivisor(mon);
+}
+
+void GetBasisTops(const PolynomSet &basis, DivisorIndex& basisTops);
+/**множества мономов, используемые Preprocess().
+Передаются вызывающим, чтоб на каждом шаге F4 хеш-таблицы очищались через MonomialMap::clear(), а не выделялись заново.
+*/
+struct PreprocessMonomials{
+	///мономы, для которых препроцессор уже искался
+	MonomialMap processed;
+	///мономы, ожидающие поиска препроцессора
+	MonomialMap toProcess;
+};
+
+void Preprocess (PolynomSet& polys, PolynomSet& reducers, ThreadPool* pool=0, PreprocessMonomials* monomials=0);
 bool cmpForReduceBySize(const CPolynomial& a, const CPolynomial &b);
 bool cmpForReduceByOrder(const CPolynomial& a, const CPolynomial &b);
 void AutoReduceBasis(PolynomSet& basis, const F4AlgData* f4options);
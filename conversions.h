@@ -8,6 +8,8 @@
 */
 
 namespace F4MPI{
+class ThreadPool;
+
 /**полином -> строка матрицы
 преобразует полином \a p в строку матрицы, используя соотвествие между мономами и номерами столбцов \a M,
 и записывает её на место \a result
@@ -21,7 +23,7 @@ void polynomialToRow(const CPolynomial &p, const MonomialMap &M, Row& result){
 		//Это условие надо убрать, когда в полиномах перестанут попадаться нули
 		if (coef->value!=0){
 			//к этому моменту в M уже должны быть все мономы из матрицы(при вызове из PolyToMatrix)
-			coef->column = M.getMonomialID(p.getMon(i));
+			coef->column = M.getMonomialID(p.getMonID(i));
 			++coef;
 		}
 	}
@@ -37,10 +39,10 @@ void rowToPolynomial(const Row& r,const MonomialMap &M, CPolynomial& result){
 	result.resize(r.size());
 	typename Row::const_iterator copyFrom = r.begin();
 	typename Row::const_iterator copyFromEnd = r.end();
-	typename CPolynomial::m_iterator mcopyTo=result.m_begin();
 	typename CPolynomial::c_iterator ccopyTo=result.c_begin();
-	for( ; copyFrom!=copyFromEnd; ++copyFrom, ++ccopyTo, ++mcopyTo){
-		*mcopyTo=M.getMonomialRev(copyFrom->column);
+	//мономы переносятся номерами в таблице мономов
+	for(int i = 0; copyFrom!=copyFromEnd; ++copyFrom, ++ccopyTo, ++i){
+		result.getMonID(i)=M.getMonomialRevID(copyFrom->column);
 		*ccopyTo=copyFrom->value;	
 	}		
 }	
@@ -56,27 +58,39 @@ void matrixToPoly(const CMatrix& m, PolynomialSet& polys, const MonomialMap& ign
 		const typename CMatrix::Row& R = m.getRow(i);
 		if(R.empty())
 			continue;
-		if (ignoreLines.containsMonomial(m.getMonomialMap().getMonomialRev(R.front().column))) continue;
+		if (ignoreLines.containsMonomial(m.getMonomialMap().getMonomialRevID(R.front().column))) continue;
 		polys.resize(polys.size()+1);//Добавить пустой многочлен в множество
 		rowToPolynomial(R,m.getMonomialMap(),polys.back());//записать на его место преобразованную строку
 	}
 }
 
+/**Строит соответсвие между мономами и номерами столбцов матрицы для набора полиномов \a polys.
+Номера столбцов возрастают при убывании мономов. Мономы сортируются с помощью пула потоков \a pool, если он задан.
+Прежнее содержимое \a M удаляется, а выделенная под него память используется повторно.
+*/
+template <class PolynomialSet, class MonomialMap>
+void storeMatrixMonomials(const PolynomialSet& polys, MonomialMap& M, ThreadPool* pool=0){
+	M.clear();
+	//старшие мономы строк почти все различны, поэтому столбцов не меньше, чем строк
+	M.reserve(polys.size());
+	//добавим в M все мономы, которые будут в матрице
+	for(typename PolynomialSet::const_iterator i = polys.begin(); i!=polys.end(); ++i){
+		storeMonomialsFromPoly(M, *i);
+	}
+	//переупорядочим мономы в M по возростанию
+	M.UpdateForUsingReversed(pool);
+}
+
 /**набор полиномов -> матрица
 Строит соответсвие между мономами и номерами столбцов создаваемой матрицы
 и сохраняет его в матрицы для использования в последствии при обратоном преобразовании.
 Далее преобразует набор полиномов \a polys в строки матрицы \a m, используя это соотвествие.
 */
 template <class CMatrix, class PolynomialSet>
-void polyToMatrix(const PolynomialSet& polys, CMatrix& m){
+void polyToMatrix(const PolynomialSet& polys, CMatrix& m, ThreadPool* pool=0){
 	m.clear();
 	m.resize(polys.size());
-	//добавим в M все мономы, которые будут в матрице
-	for(typename PolynomialSet::const_iterator i = polys.begin(); i!=polys.end(); ++i){
-		storeMonomialsFromPoly(m.getMonomialMap(), *i);
-	}
-	//переупорядочим мономы в M по возростанию
-	m.getMonomialMap().UpdateForUsingReversed();
+	storeMatrixMonomials(polys,m.getMonomialMap(),pool);
 	typename CMatrix::iterator row=m.begin();
 	for(typename PolynomialSet::const_iterator i = polys.begin(); i!=polys.end(); ++i,++row){
 		polynomialToRow(*i,m.getMonomialMap(),*row);
@@ -84,4 +98,26 @@ void polyToMatrix(const PolynomialSet& polys, CMatrix& m){
 	}
 	m.resize(row-m.begin());///
 }
+
+/**набор полиномов -> непрерывно хранимая матрица
+Аналогична polyToMatrix(), но записывает строки в \a m подряд, без выделения памяти под каждую строку.
+Соответствие между мономами и номерами столбцов строится в \a M (обычно это MonomialMap матрицы, в которую попадёт результат редукции).
+*/
+template <class CSRMatrix, class PolynomialSet, class MonomialMap>
+void polyToCSRMatrix(const PolynomialSet& polys, MonomialMap& M, CSRMatrix& m, ThreadPool* pool=0){
+	m.clear();
+	storeMatrixMonomials(polys,M,pool);
+	size_t elements=0;
+	for(typename PolynomialSet::const_iterator i = polys.begin(); i!=polys.end(); ++i){
+		elements+=i->size();
+	}
+	m.reserve(polys.size(),elements);
+	for(typename PolynomialSet::const_iterator i = polys.begin(); i!=polys.end(); ++i){
+		for(int j = 0; j!=int(i->size()); ++j){
+			//нулевые коэффициенты пропускаются, как и в polynomialToRow()
+			if (i->getCoeff(j)!=0) m.appendElement(M.getMonomialID(i->getMonID(j)),i->getCoeff(j));
+		}
+		m.finishRow();//пустые строки не сохраняются
+	}
+}
 } //namespace F4MPI
@@ -22,26 +22,26 @@ void CPlainPolynomial::addCPolynomialMultiplied(const CPlainPolynomial& p1, cons
 	int i1f = p1.size();
 	int i2f = p2.size();
 
-	CMonomial M;
+	MonomialID M;
 	Result.reserve(i1f + i2f);
 
 	while(i1!=i1f && i2!=i2f){			
-		int dif = p1.getMon(i1).compareTo(p2.getMon(i2));
+		int dif = p1.getMonID(i1)==p2.getMonID(i2) ? 0 : p1.getMon(i1).compareTo(p2.getMon(i2));
 		CModular c;
 		if(dif==0){				
 			c = p1.getCoeff(i1) +addCoeff*p2.getCoeff(i2);
-			M = p1.getMon(i1);
+			M = p1.getMonID(i1);
 			++i1;
 			++i2;
 		}		
 		else if(dif>0){
 			c = p1.getCoeff(i1);
-			M = p1.getMon(i1);				
+			M = p1.getMonID(i1);				
 			++i1;
 		}		
 		else{
 			c = addCoeff*p2.getCoeff(i2);
-			M = p2.getMon(i2);				
+			M = p2.getMonID(i2);				
 			++i2;
 		}
 		if(c!=0){
@@ -51,7 +51,7 @@ void CPlainPolynomial::addCPolynomialMultiplied(const CPlainPolynomial& p1, cons
 	while(i1!=i1f){			
 		CModular c;
 		c = p1.getCoeff(i1);
-		M = p1.getMon(i1);				
+		M = p1.getMonID(i1);				
 		if(c!=0){
 			Result.pushTermBack(c, M);
 		}
@@ -61,7 +61,7 @@ void CPlainPolynomial::addCPolynomialMultiplied(const CPlainPolynomial& p1, cons
 	while(i2!=i2f){			
 		CModular c;
 		c = addCoeff*p2.getCoeff(i2);
-		M = p2.getMon(i2);
+		M = p2.getMonID(i2);
 		if(c!=0){
 			Result.pushTermBack(c, M);
 		}
@@ -77,35 +77,37 @@ void CPlainPolynomial::addCPolynomialMultipliedWithMonom(const CPlainPolynomial&
 		addCPolynomialMultiplied(p1, p2, addCoeff, Result);
 		return;
 	}
+	MonomialTable& table = globalF4MPI::InternedMonomials;
 	int i1 = 0;
 	int i2 = 0;
 	int i1f = p1.size();
 	int i2f = p2.size();
 
-	CMonomial M, mon2;
+	const MonomialID addID = table.intern(addMon);
+	MonomialID M, mon2 = 0;
 	Result.reserve(i1f + i2f);
 
-	if (i2!=i2f) mon2 = p2.getMon(i2) * addMon;
+	if (i2!=i2f) mon2 = table.mul(p2.getMonID(i2), addID);
 	while(i1!=i1f && i2!=i2f){
-		int dif = p1.getMon(i1).compareTo(mon2);
+		int dif = p1.getMonID(i1)==mon2 ? 0 : p1.getMon(i1).compareTo(table.get(mon2));
 		CModular c;
 		if(dif==0){				
 			c = p1.getCoeff(i1) +addCoeff*p2.getCoeff(i2);
 			M = mon2;
 			++i1;
 			++i2;
-			if (i2!=i2f) mon2 = p2.getMon(i2) * addMon;
+			if (i2!=i2f) mon2 = table.mul(p2.getMonID(i2), addID);
 		}		
 		else if(dif>0){
 			c = p1.getCoeff(i1);
-			M = p1.getMon(i1);				
+			M = p1.getMonID(i1);				
 			++i1;
 		}		
 		else{
 			c = addCoeff*p2.getCoeff(i2);
 			M = mon2;				
 			++i2;
-			if (i2!=i2f) mon2 = p2.getMon(i2) * addMon;
+			if (i2!=i2f) mon2 = table.mul(p2.getMonID(i2), addID);
 		}
 		if(c!=0){
 			Result.pushTermBack(c, M);
@@ -114,7 +116,7 @@ void CPlainPolynomial::addCPolynomialMultipliedWithMonom(const CPlainPolynomial&
 	while(i1!=i1f){			
 		CModular c;
 		c = p1.getCoeff(i1);
-		M = p1.getMon(i1);				
+		M = p1.getMonID(i1);				
 		Result.pushTermBack(c, M);
 		++i1;
 	}
@@ -122,7 +124,7 @@ void CPlainPolynomial::addCPolynomialMultipliedWithMonom(const CPlainPolynomial&
 	while(i2!=i2f){			
 		CModular c;
 		c = addCoeff * p2.getCoeff(i2);
-		M = addMon * p2.getMon(i2);
+		M = table.mul(p2.getMonID(i2), addID);
 		Result.pushTermBack(c, M);
 		++i2;
 	}
@@ -159,15 +161,14 @@ CPlainPolynomial CPlainPolynomial::operator*(const CPlainPolynomial& p)const{
 }
 
 void CPlainPolynomial::addTerm(CModular c, const CMonomial& m){
-	m_iterator i=mons.begin();
-	while (i!=mons.end() && (m.compareTo(*i) < 0)) ++i;
-	coeffs.insert(coeffs.begin()+(i-mons.begin()),c);
-	mons.insert(i,m);
+	size_t i=0;
+	while (i!=mons.size() && (m.compareTo(getMon(i)) < 0)) ++i;
+	coeffs.insert(coeffs.begin()+i,c);
+	mons.insert(mons.begin()+i,globalF4MPI::InternedMonomials.intern(m));
 }
 
 void CPlainPolynomial::pushTermBack(CModular c, const CMonomial& m){
-	mons.push_back(m);
-	coeffs.push_back(c);
+	pushTermBack(c, globalF4MPI::InternedMonomials.intern(m));
 }
 
 void CPlainPolynomial::printPolynomial(ostream& output, ParserVarNames* names) const {
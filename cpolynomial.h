@@ -8,8 +8,10 @@
 */
 
 #include "cmonomial.h"
+#include "monomialtable.h"
 #include "cmodular.h"
 #include "algs.h"
+#include "simdkernels.h"
 
 #include <vector>
 #include <cassert>
@@ -25,11 +27,10 @@ private:
 	///тип содержащий массив коэффициентов
 	typedef std::vector<CModular> CoeffContanier;
 	/**тип содержащий массив мономов.
-	Поскольку размер, занимаемый мономом не известен заранее,
-	а использование хранения данных мономов во внешней памяти в виде CMonomial неэффективно,
-	применяется PODvecSize<MonomialInPoly> - массив элементов, размер которых не известен на момент компиляции.
+	Сами мономы хранятся в общей таблице globalF4MPI::InternedMonomials, а многочлен хранит только их номера,
+	поэтому одинаковые мономы разных многочленов не дублируются, а их сравнение на равенство - сравнение чисел.
 	*/
-	typedef PODvecSize<MonomialInPoly> MonomialContanier;
+	typedef std::vector<MonomialID> MonomialContanier;
 	/**коэффициенты при мономах.
 	Нулевые коэффициенты в массиве отсутсвуют.
 	*/
@@ -43,9 +44,9 @@ public:
 	///итераторы по коээфициентам при мономах
 	typedef CoeffContanier::iterator c_iterator;
 	typedef CoeffContanier::const_iterator c_const_iterator;
-	//итераторы мономам
-	typedef MonomialContanier::iterator m_iterator;
-	typedef MonomialContanier::const_iterator m_const_iterator;
+	///итераторы по мономам; мономы изменяются только через номера (см. getMonID())
+	typedef InternedMonomialIterator m_iterator;
+	typedef InternedMonomialIterator m_const_iterator;
 	
 	CPlainPolynomial(){}
 
@@ -83,22 +84,14 @@ public:
 		(*this)*=CModular::inverseMod(HC());
 	}
 
-	m_const_iterator m_end()const{
-		return mons.end();
-	}
-
-	m_const_iterator m_begin()const{
-		return mons.begin();
-	}
-
 	///возвращает итератор по мономам - позиция за последним
-	m_iterator m_end(){
-		return mons.end();
+	m_const_iterator m_end()const{
+		return m_const_iterator(mons.data()+mons.size());
 	}
 
 	///возвращает итератор по мономам - начальная позиция
-	m_iterator m_begin(){
-		return mons.begin();
+	m_const_iterator m_begin()const{
+		return m_const_iterator(mons.data());
 	}
 
 	///возвращает итератор по коэффициентам - позиция за последним
@@ -112,11 +105,16 @@ public:
 	}
 
 	const MonomialInPoly& getMon(int i)const{
+		return globalF4MPI::InternedMonomials.get(mons[i]);
+	}
+
+	///номер i-го монома в globalF4MPI::InternedMonomials
+	MonomialID getMonID(int i)const{
 		return mons[i];
 	}
 
-	///Возвращает ссылку на i-й моном
-	MonomialInPoly& getMon(int i){
+	///Возвращает ссылку на номер i-го монома
+	MonomialID& getMonID(int i){
 		return mons[i];
 	}
 
@@ -142,6 +140,12 @@ public:
 	*/
 	void pushTermBack(CModular c, const CMonomial& m);
 
+	///добавляет терм в конец полинома по номеру монома \a m; требования те же, что и у pushTermBack(CModular, const CMonomial&)
+	void pushTermBack(CModular c, MonomialID m){
+		mons.push_back(m);
+		coeffs.push_back(c);
+	}
+
 	/**
 	Текстовое представление полинома.
 	Выводит мнгочлен в текстовос виде.
@@ -171,8 +175,8 @@ public:
 	int compareTo(const CPlainPolynomial& p2)const{
 		int res;
 		for (int i=0,iend=std::min(size(),p2.size());i!=iend;++i){
-			res=getMon(i).compareTo(p2.getMon(i));
-			if (res) return res;
+			//различные номера соответствуют различным мономам
+			if (getMonID(i)!=p2.getMonID(i)) return getMon(i).compareTo(p2.getMon(i));
 			res=getCoeff(i).compareTo(p2.getCoeff(i));
 			if (res) return res;
 		}
@@ -221,7 +225,7 @@ public:
 		if (optimalhashsz<4) optimalhashsz=size()/5;
 		if (optimalhashsz<3) optimalhashsz=size();
 		for (int i=0;i<optimalhashsz;++i){
-			res=(res*2+getMon(i).hash())^384923;
+			res=(res*2+int(getMon(i).hash()))^384923;
 		}
 		return res;
 	}
@@ -230,9 +234,10 @@ public:
 	CPlainPolynomial& operator*= (const CMonomial& givenMonomial){
 		if (!(givenMonomial.isOne()))
 		{
-			for(m_iterator i = mons.begin();i!=mons.end(); ++i)
+			const MonomialID by=globalF4MPI::InternedMonomials.intern(givenMonomial);
+			for(MonomialID& m: mons)
 			{
-				(*i)*=givenMonomial;
+				m=globalF4MPI::InternedMonomials.mul(m,by);
 			}
 		}
 		return *this;
@@ -242,22 +247,23 @@ public:
 	Присваивает данному полинома \a poly умноженный на \a givenMonomial без линих копирований
 	*/
 	void AssignMultiply(const CPlainPolynomial& poly,const CMonomial& givenMonomial){
+		AssignMultiply(poly,globalF4MPI::InternedMonomials.intern(givenMonomial));
+	}
+
+	///присваивание полинома \a poly, умноженного на моном с номером \a by в таблице мономов
+	void AssignMultiply(const CPlainPolynomial& poly,MonomialID by){
 		coeffs=poly.coeffs;
 		mons.resize(poly.mons.size());
-		m_iterator To;
-		m_const_iterator From;
-		for(From = poly.m_begin(), To=m_begin(); To!=m_end(); ++To, ++From){
-			To->assignmul(*From,givenMonomial);
+		for(size_t i=0; i!=mons.size(); ++i){
+			mons[i]=globalF4MPI::InternedMonomials.mul(poly.mons[i],by);
 		}
 	}
 
 	///домножение на коэффициент
 	CPlainPolynomial& operator*= (CModular c){
-		if (c!=CModular(1)){
-			c_iterator i;
-			for(i = coeffs.begin(); i!=coeffs.end(); ++i){
-				(*i)*=c;
-			}
+		if (c!=CModular(1) && !coeffs.empty()){
+			static_assert(sizeof(CModular)==sizeof(int32_t),"CModular must be stored as a 32-bit integer");
+			SIMD::mulModContiguous(reinterpret_cast<int32_t*>(&coeffs.front()),int(coeffs.size()),c.toint(),CModular::getMOD());
 		}			
 		return *this;
 	}
@@ -320,16 +326,6 @@ class CRefPolynomial{
 		return cpoly().m_begin();
 	}
 
-	m_iterator m_end(){
-		poly.makeUnique();
-		return poly->m_end();
-	}
-
-	m_iterator m_begin(){
-		poly.makeUnique();
-		return poly->m_begin();
-	}
-
 	c_iterator c_end(){
 		poly.makeUnique();
 		return poly->c_end();
@@ -341,12 +337,16 @@ class CRefPolynomial{
 	}
 
 	const MonomialInPoly& getMon(int i)const{
-		return poly->getMon(i);
+		return cpoly().getMon(i);
+	}
+
+	MonomialID getMonID(int i)const{
+		return cpoly().getMonID(i);
 	}
 
-	MonomialInPoly& getMon(int i){
+	MonomialID& getMonID(int i){
 		poly.makeUnique();
-		return poly->getMon(i);
+		return poly->getMonID(i);
 	}
 
 	CModular getCoeff(int i)const{
@@ -369,6 +369,11 @@ class CRefPolynomial{
 		poly->pushTermBack(c,m);
 	}
 
+	void pushTermBack(CModular c, MonomialID m){
+		poly.makeUnique();
+		poly->pushTermBack(c,m);
+	}
+
 	void printPolynomial(std::ostream& output,ParserVarNames* names=0) const{
 		poly->printPolynomial(output, names);
 	}
@@ -443,6 +448,13 @@ class CRefPolynomial{
 		return *this;
 	}
 
+	///присваивание полинома \a p, умноженного на моном с номером \a by; данные \a p не копируются
+	void AssignMultiply(const CRefPolynomial& p, MonomialID by){
+		CPlainPolynomial* result=new CPlainPolynomial();
+		result->AssignMultiply(*p.poly,by);
+		poly.reset(result);
+	}
+
 	//умножение на коэффициент
 	CRefPolynomial& operator*= (CModular c){
 		poly.makeUnique();
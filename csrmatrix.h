@@ -0,0 +1,162 @@
+#ifndef CSRMatrix_h
+#define CSRMatrix_h
+/**
+\file
+Непрерывное (CSR) хранение строк матрицы.
+Определяет тип CSRMatrix, хранящий все строки матрицы в трёх общих массивах (номера столбцов, значения, начала строк),
+и тип CSRRow, представляющий отдельную строку такой матрицы без копирования её элементов.
+*/
+
+#include "cmatrix.h"
+
+#include <vector>
+#include <cstdint>
+
+namespace F4MPI{
+/**Строка матрицы CSRMatrix.
+Указывает на элементы строки внутри массивов матрицы и остаётся верной, пока в матрицу не добавляются строки.
+Элементы упорядочены по возрастанию номера столбца, как и в CRow.
+Значения хранятся либо в массиве \a values, либо (для модулей не больше 2^16) в массиве 16-битных вычетов \a values16;
+второй указатель при этом нулевой.
+*/
+struct CSRRow{
+	///номера столбцов ненулевых элементов
+	const int* columns;
+	///значения ненулевых элементов или NULL при 16-битном хранении
+	const CModular* values;
+	///значения ненулевых элементов при 16-битном хранении или NULL
+	const uint16_t* values16;
+	///число ненулевых элементов
+	int size;
+
+	///значение \a i-го ненулевого элемента
+	CModular value(int i)const{
+		return values16 ? CModular::fromReduced(values16[i]) : values[i];
+	}
+
+	bool empty()const{
+		return size==0;
+	}
+
+	///номер ведущего столбца; строка не должна быть пустой
+	int HM()const{
+		return columns[0];
+	}
+
+	///ведущий элемент; строка не должна быть пустой
+	CModular HC()const{
+		return value(0);
+	}
+
+	///номер последнего столбца; строка не должна быть пустой
+	int lastColumn()const{
+		return columns[size-1];
+	}
+
+	///записывает строку в \a row
+	void copyTo(CRow& row)const{
+		row.resize(size);
+		for (int i=0;i<size;++i){
+			row[i].column=columns[i];
+			row[i].value=value(i);
+		}
+	}
+};
+
+/**Матрица с непрерывным хранением строк.
+Строки только добавляются в конец, что позволяет хранить их без отдельного выделения памяти под каждую строку.
+Номера столбцов и значения хранятся в отдельных массивах, строка i занимает в них элементы [rowStarts[i];rowStarts[i+1]).
+Если модуль не превосходит 2^16, значения хранятся 16-битными, что вдвое сокращает объём читаемых при редукции значений.
+Ширина значений выбирается при создании и очистке матрицы по текущему модулю CModular.
+Используется для строк, которые при редукции только читаются (опорные строки блочной декомпозиции).
+*/
+class CSRMatrix{
+	std::vector<int> columns;
+	std::vector<CModular> values;
+	std::vector<uint16_t> values16;
+	std::vector<int> rowStarts;
+	///хранятся ли значения в values16
+	bool shortValues;
+
+	void chooseValueWidth(){
+		shortValues=CModular::getMOD()<=(1<<16);
+	}
+  public:
+	CSRMatrix():rowStarts(1,0){
+		chooseValueWidth();
+	}
+
+	void clear(){
+		columns.clear();
+		values.clear();
+		values16.clear();
+		rowStarts.assign(1,0);
+		chooseValueWidth();
+	}
+
+	///резервирует память под \a rows строк с суммарно \a elements элементами
+	void reserve(size_t rows, size_t elements){
+		rowStarts.reserve(rows+1);
+		columns.reserve(elements);
+		if (shortValues) values16.reserve(elements);
+		else values.reserve(elements);
+	}
+
+	///хранятся ли значения 16-битными
+	bool hasShortValues()const{
+		return shortValues;
+	}
+
+	///число строк
+	int size()const{
+		return int(rowStarts.size())-1;
+	}
+
+	bool empty()const{
+		return size()==0;
+	}
+
+	///суммарное число ненулевых элементов во всех строках
+	int elements()const{
+		return rowStarts.back();
+	}
+
+	/**добавляет элемент к формируемой строке.
+	Элементы строки должны добавляться по возрастанию номера столбца, строка завершается вызовом finishRow().
+	*/
+	void appendElement(int column, CModular value){
+		columns.push_back(column);
+		if (shortValues) values16.push_back(uint16_t(value.toint()));
+		else values.push_back(value);
+	}
+
+	/**завершает формирование строки из элементов, добавленных после предыдущего вызова.
+	Пустые строки не сохраняются.
+	*/
+	void finishRow(){
+		if (int(columns.size())!=rowStarts.back()) rowStarts.push_back(columns.size());
+	}
+
+	///добавляет копию строки \a row
+	void appendRow(const CRow& row){
+		for (CRow::const_iterator i=row.begin();i!=row.end();++i){
+			appendElement(i->column,i->value);
+		}
+		finishRow();
+	}
+
+	CSRRow getRow(int i)const{
+		CSRRow r;
+		r.columns=columns.data()+rowStarts[i];
+		r.values=shortValues ? 0 : values.data()+rowStarts[i];
+		r.values16=shortValues ? values16.data()+rowStarts[i] : 0;
+		r.size=rowStarts[i+1]-rowStarts[i];
+		return r;
+	}
+
+	CSRRow operator[](int i)const{
+		return getRow(i);
+	}
+};
+} //namespace F4MPI
+#endif
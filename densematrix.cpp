@@ -0,0 +1,164 @@
+/**
+\file
+Реализация плотных матриц и блочного метода Гаусса для них
+*/
+#include "densematrix.h"
+#include "modpolicy.h"
+#include "simdkernels.h"
+
+#include <algorithm>
+#include <limits>
+
+using namespace std;
+namespace F4MPI{
+
+namespace{
+///наибольшее число ведущих строк в панели
+const int panelRows=16;
+///число столбцов в участке строки, обрабатываемом за один проход по панели
+const int tileColumns=512;
+///число строк в одной задаче пула потоков при вычитании панели
+const int rowsPerTask=16;
+}
+
+DenseMatrix::DenseMatrix(int rows, int columns):
+		nRows(rows),
+		nColumns(columns),
+		data(size_t(rows)*columns,0)
+{}
+
+///реализация DenseMatrix::rowEchelonForm() для политики арифметики \a Modulus
+template <class Modulus>
+struct DenseEchelonKernel{
+	const Modulus& mod;
+	DenseMatrix& m;
+	const int width;
+	const uint32_t p;
+	///число умножений-сложений, после которого суммы нужно привести по модулю, чтобы избежать переполнения
+	uint64_t maxAdds;
+	vector<int>& pivot;
+
+	DenseEchelonKernel(const Modulus& modulus, DenseMatrix& matrix):
+			mod(modulus),
+			m(matrix),
+			width(matrix.nColumns),
+			p(modulus.value()),
+			pivot(matrix.pivotColumns)
+	{
+		const uint64_t maxProduct=uint64_t(p-1)*(p-1);
+		maxAdds=maxProduct ? (numeric_limits<uint64_t>::max()-(p-1))/maxProduct : numeric_limits<uint64_t>::max();
+	}
+
+	/**вычитает из строки \a r строки панели [\a from;\a to) так, чтобы обнулить её элементы в их ведущих столбцах.
+	Строки панели нормализованы и взаимно редуцированы, поэтому все коэффициенты берутся из \a r до вычитания.
+	*/
+	void subtractPanel(uint32_t* r, int from, int to)const{
+		uint64_t coef[panelRows];
+		int firstColumn=width;
+		for (int k=from;k<to;++k){
+			const uint32_t a=r[pivot[k]];
+			coef[k-from]=a ? p-a : 0;
+			if (a) firstColumn=min(firstColumn,pivot[k]);
+		}
+		uint64_t tmp[tileColumns];
+		for (int j0=firstColumn;j0<width;j0+=tileColumns){
+			const int j1=min(j0+tileColumns,width);
+			for (int j=j0;j<j1;++j) tmp[j-j0]=r[j];
+			uint64_t adds=0;
+			for (int k=from;k<to;++k){
+				//строка панели нулевая левее своего ведущего столбца
+				if (!coef[k-from] || pivot[k]>=j1) continue;
+				if (adds==maxAdds){
+					for (int j=0;j<j1-j0;++j) tmp[j]=mod.reduce(tmp[j]);
+					adds=0;
+				}
+				const int start=max(j0,pivot[k]);
+				SIMD::addScaledDense(tmp+(start-j0),m.row(k)+start,j1-start,coef[k-from]);
+				++adds;
+			}
+			for (int j=j0;j<j1;++j) r[j]=mod.reduce(tmp[j-j0]);
+		}
+	}
+
+	///делает единичным элемент строки \a r в столбце \a c, левее которого строка нулевая
+	void normalize(uint32_t* r, int c)const{
+		const int inv=CModular::inverseMod(CModular::fromReduced(r[c])).toint();
+		SIMD::mulModContiguous(reinterpret_cast<int32_t*>(r+c),width-c,inv,p);
+	}
+
+	///обнуляет элементы строк панели [\a from;\a to) в столбце \a c новой ведущей строкой \a r
+	void eliminateInPanel(const uint32_t* r, int c, int from, int to)const{
+		for (int k=from;k<to;++k){
+			uint32_t* q=m.row(k);
+			const uint32_t a=q[c];
+			if (!a) continue;
+			const uint64_t mult=p-a;
+			for (int j=c;j<width;++j){
+				q[j]=mod.reduce(q[j]+mult*r[j]);
+			}
+		}
+	}
+
+	/**вычитает заполненную панель [\a from;\a to) из ещё не обработанных строк [\a to;\a n),
+	а при \a reduced - и из ведущих строк предыдущих панелей
+	*/
+	void flushPanel(int from, int to, int n, bool reduced, ThreadPool* pool)const{
+		const int above=reduced ? from : 0;
+		const int total=above+(n-to);
+		const int tasks=(total+rowsPerTask-1)/rowsPerTask;
+		ThreadPool::Task task=[&](int t){
+			const int last=min(total,(t+1)*rowsPerTask);
+			for (int i=t*rowsPerTask;i<last;++i){
+				subtractPanel(m.row(i<above ? i : to+(i-above)),from,to);
+			}
+		};
+		if (pool && tasks>1){
+			pool->parallelFor(tasks,task);
+		}else{
+			for (int t=0;t<tasks;++t) task(t);
+		}
+	}
+
+	static void run(const Modulus& mod, DenseMatrix& m, bool reduced, ThreadPool* pool, int& rank){
+		DenseEchelonKernel kernel(mod,m);
+		rank=kernel.eliminate(reduced,pool);
+	}
+
+	int eliminate(bool reduced, ThreadPool* pool){
+		int n=m.nRows;
+		pivot.assign(n,-1);
+		int rank=0;
+		//текущая панель - ведущие строки [panelStart;rank)
+		int panelStart=0;
+		while (rank<n){
+			uint32_t* r=m.row(rank);
+			//предыдущие панели уже вычтены из строки при их заполнении
+			subtractPanel(r,panelStart,rank);
+			const int c=int(find_if(r,r+width,[](uint32_t v){return v!=0;})-r);
+			if (c==width){
+				//нулевые строки переносятся в конец матрицы
+				--n;
+				if (rank!=n) swap_ranges(r,r+width,m.row(n));
+			}else{
+				normalize(r,c);
+				eliminateInPanel(r,c,panelStart,rank);
+				pivot[rank]=c;
+				++rank;
+			}
+			if (rank>panelStart && (rank-panelStart==panelRows || rank==n)){
+				flushPanel(panelStart,rank,n,reduced,pool);
+				panelStart=rank;
+			}
+		}
+		pivot.resize(rank);
+		return rank;
+	}
+};
+
+int DenseMatrix::rowEchelonForm(bool reduced, ThreadPool* pool){
+	int rank=0;
+	runWithModulusPolicy<DenseEchelonKernel>(*this,reduced,pool,rank);
+	return rank;
+}
+
+} //namespace F4MPI
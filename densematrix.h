@@ -0,0 +1,64 @@
+#ifndef DenseMatrix_h
+#define DenseMatrix_h
+/**
+\file
+Плотное представление матриц для исключения заполненных блоков.
+Определяет тип DenseMatrix, хранящий все элементы матрицы (включая нулевые) построчно в одном массиве,
+и блочный метод Гаусса для него. Используется для блока D блочной декомпозиции,
+когда после редукции по опорным строкам он оказывается достаточно заполненным.
+*/
+
+#include "threadpool.h"
+
+#include <vector>
+#include <cstdint>
+
+namespace F4MPI{
+/**Плотная матрица над полем вычетов по текущему модулю CModular.
+Элементы хранятся приведёнными 32-битными вычетами, строка i занимает элементы [i*columns();(i+1)*columns()).
+*/
+class DenseMatrix{
+	int nRows, nColumns;
+	std::vector<uint32_t> data;
+	///ведущие столбцы строк после rowEchelonForm()
+	std::vector<int> pivotColumns;
+  public:
+	///создаёт нулевую матрицу размера \a rows x \a columns
+	DenseMatrix(int rows, int columns);
+
+	int rows()const{
+		return nRows;
+	}
+
+	int columns()const{
+		return nColumns;
+	}
+
+	uint32_t* row(int i){
+		return &data[size_t(i)*nColumns];
+	}
+
+	const uint32_t* row(int i)const{
+		return &data[size_t(i)*nColumns];
+	}
+
+	/**приводит матрицу к ступенчатому виду блочным методом Гаусса.
+	Ведущие строки собираются в панели по несколько строк, взаимно редуцированные внутри панели.
+	Заполненная панель вычитается из остальных строк за один проход по каждой строке
+	с отложенным взятием по модулю, причём строка обрабатывается участками столбцов, помещающимися в кеш.
+	По окончании первые rank строк (rank - возвращаемое значение) ненулевые, нормализованы (ведущий элемент равен 1)
+	и имеют различные ведущие столбцы, остальные строки нулевые. Порядок строк не связан с порядком ведущих столбцов.
+	\param reduced приводить ли к сильно ступенчатому виду (обнулять элементы над ведущими)
+	\param pool пул потоков для вычитания панелей или NULL
+	*/
+	int rowEchelonForm(bool reduced, ThreadPool* pool=0);
+
+	///ведущий столбец строки \a i после rowEchelonForm()
+	int pivotColumn(int i)const{
+		return pivotColumns[i];
+	}
+
+	template <class Modulus> friend struct DenseEchelonKernel;
+};
+} //namespace F4MPI
+#endif
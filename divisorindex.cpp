@@ -0,0 +1,140 @@
+/**
+\file
+Реализация индекса делимости мономов
+*/
+#include "divisorindex.h"
+
+#include <algorithm>
+#include <climits>
+
+using namespace std;
+namespace F4MPI{
+
+void DivisorIndex::clear(){
+	nodes.assign(1,Node());
+	makeLeaf(0,-1);
+	freeNodes.clear();
+	count=0;
+}
+
+void DivisorIndex::makeLeaf(int n, int parent){
+	Node& node=nodes[n];
+	node.var=-1;
+	node.parent=parent;
+	node.minValue=INT_MAX;
+	node.limit=leafSize;
+	node.entries=vector<Entry>();
+}
+
+int DivisorIndex::leafOf(const CInternalMonomial& m)const{
+	int n=0;
+	while (nodes[n].var>=0) n=nodes[n].child[m.getDegree(nodes[n].var)>=nodes[n].exponent];
+	return n;
+}
+
+void DivisorIndex::insert(MonomialID monomial, int value){
+	const CInternalMonomial& m=globalF4MPI::InternedMonomials.get(monomial);
+	const int leaf=leafOf(m);
+	nodes[leaf].entries.push_back(Entry{monomial,m.divMask(),value});
+	++count;
+	for (int n=leaf;n>=0 && nodes[n].minValue>value;n=nodes[n].parent) nodes[n].minValue=value;
+	if (nodes[leaf].entries.size()>=nodes[leaf].limit) split(leaf);
+}
+
+void DivisorIndex::split(int leaf){
+	const MonomialTable& table=globalF4MPI::InternedMonomials;
+	const vector<Entry>& entries=nodes[leaf].entries;
+	//порог - медиана степеней переменной; выбирается переменная, при которой меньшая часть наибольшая
+	int bestVar=-1, bestExponent=0;
+	size_t bestSmaller=0;
+	vector<int> degrees(entries.size());
+	for (int var=0;var<CMonomialBase::theNumberOfVariables;++var){
+		for (size_t i=0;i<entries.size();++i) degrees[i]=table.get(entries[i].monomial).getDegree(var);
+		nth_element(degrees.begin(),degrees.begin()+degrees.size()/2,degrees.end());
+		int exponent=degrees[degrees.size()/2];
+		size_t below=count_if(degrees.begin(),degrees.end(),[&](int d){return d<exponent;});
+		if (!below){
+			//медиана равна наименьшей степени: порогом становится следующая за ней степень
+			int next=0;
+			for (int d: degrees) if (d>exponent && (!next || d<next)) next=d;
+			if (!next) continue;
+			exponent=next;
+			below=count_if(degrees.begin(),degrees.end(),[&](int d){return d<exponent;});
+		}
+		const size_t smaller=min(below,degrees.size()-below);
+		if (smaller>bestSmaller){
+			bestSmaller=smaller;
+			bestVar=var;
+			bestExponent=exponent;
+		}
+	}
+	if (bestVar<0){
+		nodes[leaf].limit*=2;
+		return;
+	}
+	int child[2];
+	for (int c=0;c<2;++c){
+		if (freeNodes.empty()){
+			child[c]=int(nodes.size());
+			nodes.push_back(Node());
+		}else{
+			child[c]=freeNodes.back();
+			freeNodes.pop_back();
+		}
+		makeLeaf(child[c],leaf);
+	}
+	Node& node=nodes[leaf];
+	for (const Entry& e: node.entries){
+		Node& to=nodes[child[table.get(e.monomial).getDegree(bestVar)>=bestExponent]];
+		to.entries.push_back(e);
+		to.minValue=min(to.minValue,e.value);
+	}
+	node.entries=vector<Entry>();
+	node.var=bestVar;
+	node.exponent=bestExponent;
+	node.child[0]=child[0];
+	node.child[1]=child[1];
+}
+
+void DivisorIndex::updateMinValues(int n){
+	//minValue самого узла n мог быть перенесён вместе с ним при слиянии, поэтому его родитель пересчитывается всегда
+	for (const int start=n;n>=0;n=nodes[n].parent){
+		const Node& node=nodes[n];
+		int value=INT_MAX;
+		if (node.var<0){
+			for (const Entry& e: node.entries) value=min(value,e.value);
+		}else{
+			value=min(nodes[node.child[0]].minValue,nodes[node.child[1]].minValue);
+		}
+		if (value==node.minValue && n!=start) break;
+		nodes[n].minValue=value;
+	}
+}
+
+void DivisorIndex::collapse(const vector<int>& leaves){
+	vector<int> changed;
+	for (int n: leaves){
+		while (nodes[n].var<0 && nodes[n].entries.empty() && nodes[n].parent>=0){
+			const int parent=nodes[n].parent;
+			const int sibling=nodes[parent].child[nodes[parent].child[0]==n];
+			nodes[sibling].parent=nodes[parent].parent;
+			nodes[parent]=std::move(nodes[sibling]);
+			if (nodes[parent].var>=0){
+				for (int c: nodes[parent].child) nodes[c].parent=parent;
+			}
+			for (int freed: {n,sibling}){
+				makeLeaf(freed,freeParent);
+				freeNodes.push_back(freed);
+			}
+			//второй потомок мог тоже опустеть
+			n=parent;
+		}
+		//лист мог освободиться при слиянии соседнего листа
+		if (nodes[n].parent!=freeParent) changed.push_back(n);
+	}
+	for (int n: changed){
+		if (nodes[n].parent!=freeParent) updateMinValues(n);
+	}
+}
+
+} //namespace F4MPI
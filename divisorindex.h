@@ -0,0 +1,184 @@
+#ifndef DivisorIndex_h
+#define DivisorIndex_h
+/**
+\file
+Индекс делимости мономов: поиск делителей и кратных данного монома среди мономов множества
+*/
+
+#include "monomialtable.h"
+
+#include <vector>
+#include <climits>
+
+namespace F4MPI{
+/**множество мономов с поиском делителей и кратных данного монома.
+Мономы хранятся в k-мерном дереве (в духе Руна): внутренний узел делит мономы по степени одной переменной
+на меньшие заданного порога и остальные, а листья содержат мономы вместе с их масками делимости.
+Поиск делителей монома не заходит в поддеревья со степенями больше его степени, а поиск кратных - меньше,
+так что просматривается лишь часть листьев, а внутри листа большинство мономов отсеивается сравнением масок.
+Каждому моному сопоставлено число (обычно номер многочлена, старшим мономом которого он является);
+узел хранит наименьшее из чисел своего поддерева, и поиск делителя с наименьшим числом пропускает поддеревья, не способные его улучшить.
+Мономы задаются номерами в таблице globalF4MPI::InternedMonomials.
+*/
+class DivisorIndex{
+  public:
+	///элемент множества: номер монома, его маска делимости и сопоставленное ему число
+	struct Entry{
+		MonomialID monomial;
+		CMonomialBase::DivMask mask;
+		int value;
+	};
+  private:
+	///число элементов листа, при котором лист делится
+	static const int leafSize=32;
+	///parent свободного узла (см. freeNodes)
+	static const int freeParent=-2;
+
+	/**узел дерева.
+	Внутренний узел (var>=0) делит мономы по степени переменной var (с 0): в child[0] - со степенью меньше exponent, в child[1] - остальные.
+	Лист (var<0) хранит элементы в entries и делится при достижении limit элементов.
+	Корень не имеет родителя (parent==-1), а свободный узел имеет parent==#freeParent;
+	minValue - наименьшее число элементов поддерева (INT_MAX для пустого).
+	*/
+	struct Node{
+		int var;
+		int exponent;
+		int child[2];
+		int parent;
+		int minValue;
+		size_t limit;
+		std::vector<Entry> entries;
+	};
+	std::vector<Node> nodes;
+	///номера узлов, освободившихся при слиянии пустых листьев, для повторного использования в split()
+	std::vector<int> freeNodes;
+	size_t count;
+
+	///номер листа, в который попадает моном \a m
+	int leafOf(const CInternalMonomial& m)const;
+
+	///делает узел \a n пустым листом с родителем \a parent
+	void makeLeaf(int n, int parent);
+
+	///делит лист \a leaf по переменной, дающей наиболее равные части; если все мономы листа равны, увеличивает его limit
+	void split(int leaf);
+
+	///пересчитывает minValue узла \a n и его предков, пока значения меняются
+	void updateMinValues(int n);
+
+	/**после удаления элементов из листьев \a leaves заменяет родителя каждого опустевшего листа его вторым потомком
+	и обновляет minValue
+	*/
+	void collapse(const std::vector<int>& leaves);
+
+	/**обходит листья, которые могут содержать делители (\a multiples==false) или кратные (\a multiples==true) монома \a m,
+	вызывая \a f(Node&) для каждого из них. Поддеревья, для корней которых \a skip(const Node&) возвращает \c true, не обходятся.
+	*/
+	template <class Nodes, class M, class S, class F> static void forEachLeaf(Nodes& nodes, const M& m, bool multiples, S skip, F f){
+		int stack[64];
+		std::vector<int> more;//продолжение стека для очень глубоких деревьев
+		int top=0;
+		stack[top++]=0;
+		while (top || !more.empty()){
+			int n;
+			if (!more.empty()){
+				n=more.back();
+				more.pop_back();
+			}else{
+				n=stack[--top];
+			}
+			auto& node=nodes[n];
+			if (skip(node)) continue;
+			if (node.var<0){
+				f(node);
+				continue;
+			}
+			const int d=m.getDegree(node.var);
+			//делители имеют степень не больше d, кратные - не меньше d
+			const bool visit[2]={!multiples || d<node.exponent, multiples || d>=node.exponent};
+			for (int c=0;c<2;++c){
+				if (!visit[c]) continue;
+				if (top<64){
+					stack[top++]=node.child[c];
+				}else{
+					more.push_back(node.child[c]);
+				}
+			}
+		}
+	}
+  public:
+	DivisorIndex(){
+		clear();
+	}
+
+	///удаляет все элементы
+	void clear();
+
+	///число элементов
+	size_t size()const{
+		return count;
+	}
+
+	///добавляет моном с номером \a monomial, сопоставляя ему число \a value
+	void insert(MonomialID monomial, int value);
+
+	/**вызывает \a f(const Entry&) для каждого элемента, моном которого делит \a m.
+	Обход прекращается, когда \a f возвращает \c false.
+	*/
+	template <class Placing, class F> void forEachDivisor(const MonomialWithPlacing<Placing>& m, F f)const{
+		const CMonomialBase::DivMask mask=m.divMask();
+		bool stop=false;
+		forEachLeaf(nodes,m,false,[&](const Node&){return stop;},[&](const Node& leaf){
+			for (const Entry& e: leaf.entries){
+				if (stop) return;
+				if (!(e.mask&~mask) && m.divisibleBy(globalF4MPI::InternedMonomials.get(e.monomial)) && !f(e)) stop=true;
+			}
+		});
+	}
+
+	///возвращает наименьшее из чисел, сопоставленных делителям \a m, или -1, если делителей нет
+	template <class Placing> int minimalDivisor(const MonomialWithPlacing<Placing>& m)const{
+		const CMonomialBase::DivMask mask=m.divMask();
+		int best=INT_MAX;
+		forEachLeaf(nodes,m,false,[&](const Node& node){return node.minValue>=best;},[&](const Node& leaf){
+			for (const Entry& e: leaf.entries){
+				if (e.value<best && !(e.mask&~mask) && m.divisibleBy(globalF4MPI::InternedMonomials.get(e.monomial))) best=e.value;
+			}
+		});
+		return best==INT_MAX ? -1 : best;
+	}
+
+	///возвращает \c true, если среди элементов есть делитель \a m
+	template <class Placing> bool hasDivisor(const MonomialWithPlacing<Placing>& m)const{
+		bool found=false;
+		forEachDivisor(m,[&](const Entry&){
+			found=true;
+			return false;
+		});
+		return found;
+	}
+
+	///удаляет элементы, мономы которых делятся на \a m, дописывая сопоставленные им числа в \a removed
+	template <class Placing> void removeMultiples(const MonomialWithPlacing<Placing>& m, std::vector<int>& removed){
+		const CMonomialBase::DivMask mask=m.divMask();
+		std::vector<int> changed;
+		forEachLeaf(nodes,m,true,[](const Node& node){return node.minValue==INT_MAX;},[&](Node& leaf){
+			const size_t before=leaf.entries.size();
+			for (size_t i=0;i<leaf.entries.size();){
+				const Entry& e=leaf.entries[i];
+				if (!(mask&~e.mask) && globalF4MPI::InternedMonomials.get(e.monomial).divisibleBy(m)){
+					removed.push_back(e.value);
+					leaf.entries[i]=leaf.entries.back();
+					leaf.entries.pop_back();
+					--count;
+				}else{
+					++i;
+				}
+			}
+			if (leaf.entries.size()!=before) changed.push_back(int(&leaf-nodes.data()));
+		});
+		if (!changed.empty()) collapse(changed);
+	}
+};
+} //namespace F4MPI
+#endif
@@ -77,8 +77,55 @@ typedef struct F4AlgOptions_struct {
 	 *	Выбирает запускаемый алгоритм.
 	 */
 	int selectedAlgo;
-	
-	
+
+	/**Блочная декомпозиция матрицы (Фожер-Лашартр).
+	При установке в 1 строки матрицы F4 разбиваются на опорные строки с различными ведущими столбцами (блоки A|B)
+	и остальные строки (блоки C|D). Строки C|D редуцируются по уже треугольным A|B,
+	и полный метод Гаусса проводится только для оставшегося блока D.
+	*/
+	int useABCDDecomposition;
+
+	/**Редукция строк через плотный аккумулятор.
+	При установке в 1 редуцируемая строка разворачивается в плотный массив 64-битных сумм,
+	к которому прибавляются редуцирующие строки без взятия по модулю после каждого умножения.
+	По модулю суммы приводятся только при угрозе переполнения и при сворачивании результата обратно в разреженную строку.
+	*/
+	int useDenseAccumulator;
+
+	/**Число потоков в каждом процессе.
+	При значении больше 1 редукция строк матрицы при прямом и обратном ходе метода Гаусса
+	распределяется между потоками, работающими с общей памятью процесса.
+	Может использоваться как вместе с MPI, так и вместо него при работе на одной машине.
+	*/
+	int numberOfThreads;
+
+	/**Порог заполненности для плотного исключения блока D (в процентах).
+	При блочной декомпозиции блок D, полученный после редукции по опорным строкам, переводится в плотное представление,
+	если доля ненулевых элементов в его непустых столбцах не меньше заданного процента,
+	и приводится к ступенчатому виду блочным плотным методом Гаусса вместо MPIDiagonalForm.
+	Значение 0 отключает плотное исключение.
+	*/
+	int denseBlockFilling;
+
+	/**Упакованное по битам исключение над GF(2).
+	При установке в 1 и модуле 2 матрицы приводятся к ступенчатому виду в упакованном по битам представлении
+	(сложение строк - XOR машинных слов, вычитание групп строк - методом четырёх русских),
+	если оно занимает не больше памяти, чем разреженное.
+	*/
+	int useGF2Engine;
+
+	/**Стратегия выбора S-пар.
+	На каждом шаге F4 в матрицу попадают все S-пары с наименьшей степенью НОК старших мономов (0)
+	или с наименьшим сахаром (1). Для однородных систем обе стратегии совпадают.
+	*/
+	int sPairSelection;
+
+	/**Ограничение степени S-пар.
+	При значении больше 0 S-пары, степень НОК старших мономов которых больше заданной, не рассматриваются,
+	и результатом становится базис Грёбнера, усечённый по этой степени. Значение 0 снимает ограничение.
+	*/
+	int sPairDegreeCap;
+
 } F4AlgOptions;
 
 #ifdef __cplusplus
@@ -7,113 +7,20 @@
 #include "outputroutines.h"
 #include "conversions.h"
 #include "matrixinfoimpl.h"
+#include "csrmatrix.h"
+#include "spairs.h"
 
 using namespace std;
 namespace F4MPI{
 
-/**реализация алгоритма Update.
-\param G промежуточный базис. В него добавляется новый многочлен и выкидываются некоторые старые
-\param P набор рассматриваемых S-пар, который модифицируется в соответсвии с критериями Бухбергера
-\param h новый многочлен, добавляемый в промежуточный базис
+/**Приводит матрицу \a m к ступенчатому/сильно ступенчатому виду в соответствии с \a f4options.
+При блочной декомпозиции строки матрицы передаются в непрерывном виде \a inputRows, а \a m содержит лишь соответствие мономов столбцам.
 */
-void Update(PolynomSet& G, SPairSet& P, const CPolynomial& h)
-{	
-	//MEASURE_TIME_IN_BLOCK("Update");
-	vector<int> D;
-	D.reserve(G.size());	
-	vector<int> Pnew;
-	Pnew.reserve(G.size());
-	CMonomial HMh = h.HM();
-	CMonomial HMg1;
-	CMonomial LCM_HMh_HMg1;
-	CMonomial HMg2;
-	CMonomial LCM_HMh_HMg2;
-	for(int i = 0; i<int(G.size()); i++)
-	{
-		HMg1 = G[i].HM();
-		bool Condition = false;
-		bool gcdOne = false;
-		if(CMonomial::gcd(HMh, HMg1).getDegree()==0)
-		{
-			Condition = true;
-			gcdOne = true;
-		}
-		else{		
-			Condition = true;
-			LCM_HMh_HMg1 = CMonomial::lcm(HMh, HMg1);			
-			for(int j = i+1; Condition && j<int(G.size()); ++j)
-			{
-				HMg2 = G[j].HM();
-				LCM_HMh_HMg2 = CMonomial::lcm(HMh, HMg2);
-				if(LCM_HMh_HMg1.divisibleBy(LCM_HMh_HMg2))
-					Condition = false;
-			}			
-			for(int j = 0; Condition && j<int(D.size()); j++)
-			{
-				HMg2 = G[D[j]].HM();
-				LCM_HMh_HMg2 = CMonomial::lcm(HMh, HMg2);
-				if(LCM_HMh_HMg1.divisibleBy(LCM_HMh_HMg2))
-					Condition = false;
-			}
-		}
-		if(Condition)
-		{
-			D.push_back(i);			
-			if(!gcdOne)
-				Pnew.push_back(i);				
-		}
-	}	
-	vector<bool> Mark(P.size()+Pnew.size());
-	fill(Mark.begin(), Mark.end(), true);
-
-	{
-		//MEASURE_TIME_IN_BLOCK("SecondCriteria");
-		CMonomial LCM_HMg1_HMg2;
-		for(int i = 0; i<int(P.size()); i++)
-		{
-			LCM_HMg1_HMg2 = CMonomial::lcm(P[i].first.HM(), P[i].second.HM());
-			if( LCM_HMg1_HMg2.divisibleBy(HMh) &&        
-				CMonomial::lcm(HMh, P[i].first.HM())!=LCM_HMg1_HMg2 &&
-				CMonomial::lcm(HMh, P[i].second.HM())!=LCM_HMg1_HMg2)
-			{
-				Mark[i] = false;
-				continue;
-			}		
-		}
-	}
-
-	{
-		//MEASURE_TIME_IN_BLOCK("MakeNewSPairs");
-		for(int i = 0; i<int(Pnew.size()); i++)
-			P.push_back(MakeSPair(h, G[Pnew[i]]));
-	}
-	{
-		//MEASURE_TIME_IN_BLOCK("EraseMarkedFromP");
-		EraseAll<SPair>(P, Mark);
-	}
-	{
-		//MEASURE_TIME_IN_BLOCK("CheckDivisibility");
-		Mark.resize(G.size());
-		for(int i = 0; i<int(G.size()); i++)
-		{
-			if(!G[i].HM().divisibleBy(HMh))
-				Mark[i] = true;
-			else
-				Mark[i] = false;
-		}
-	}
-	{
-		//MEASURE_TIME_IN_BLOCK("EraseMarkedFromG");
-		G.push_back(h);
-		Mark.push_back(true);
-		EraseAll<CPolynomial>(G, Mark);
-	}
-}
-
-	
-///Приводит матрицу \a m к ступенчатому/сильно ступенчатому виду в соответствии с \a f4options
-void doReduceMatrix(CMatrix& m, const F4AlgData* f4options){
-	if(f4options->diagonalEachStep){
+void doReduceMatrix(CMatrix& m, const CSRMatrix& inputRows, const F4AlgData* f4options){
+	if(f4options->useABCDDecomposition){
+		//строки-редукторы из препроцессинга образуют опорный блок, их ведущие столбцы известны
+		m.ABCDDecompositionForm(inputRows,f4options,f4options->diagonalEachStep);
+	}else if(f4options->diagonalEachStep){
 		m.toDiagonalNormalForm(f4options);
 	}else{
 		m.toRowEchelonForm(f4options);
@@ -121,10 +28,10 @@ void doReduceMatrix(CMatrix& m, const F4AlgData* f4options){
 }
 
 ///Редуцирует матрицу, собирая статистику по ней при необходимости
-void ReduceMatrix(CMatrix& m, const F4AlgData* f4options){
+void ReduceMatrix(CMatrix& m, const CSRMatrix& inputRows, const F4AlgData* f4options){
 	f4options->stats->totalNumberOfReducedMatr++;
-	m.doMatrixStatsPre(f4options);
-	doReduceMatrix(m,f4options);
+	m.doMatrixStatsPre(f4options,&inputRows);
+	doReduceMatrix(m,inputRows,f4options);
 	m.doMatrixStatsPost(f4options);
 	if (f4options->mpi_start_info.isMainProcess() && f4options->showInfoToStdout){
 		printf("%d matrices complete\n", f4options->stats->totalNumberOfReducedMatr);
@@ -132,72 +39,57 @@ void ReduceMatrix(CMatrix& m, const F4AlgData* f4options){
 	}
 }
 
-/**
-Подготавливает S-пару к обработке.
-Домножает многочлены S-пары на (минимально возможные) мономы таким образом, чтоб старшие их мономы стали равны друг другу
-*/
-void SPolynomial2(SPair& sp)
-{
-	CMonomial lcm = CMonomial::lcm(sp.first.HM(), sp.second.HM());
-	CMonomial M1;
-	CMonomial M2;
-	
-	lcm.tryDivide(sp.first.HM(), M1);
-	lcm.tryDivide(sp.second.HM(), M2);
-	sp.first*= M1;
-	sp.second*= M2;	
-}
-
 /**
 Выбирает S-пары для рассмотрения на следующем шаге.
-На основе S-пар выбранных из множества \a sPairs формируются многочлены, записываемые в \a ret.
+Многочлены выбранных из множества \a sPairs пар, домноженные до НОК старших мономов пары, записываются в \a ret;
+одинаковые произведения, порождаемые разными парами, вычисляются и записываются один раз.
 Из исходного множеcтва S-пар выбранные выкидываются.
+\retval сахар многочленов, которые будут получены редукцией выбранных пар
 */
-void SelectSPairs(SPairSet &sPairs, PolynomSet& ret)
+int SelectSPairs(SPairSet &sPairs, PolynomSet& ret)
 {		
 	//MEASURE_TIME_IN_BLOCK("SelectSPairs");
-	vector<bool> Mark(sPairs.size());
-	int minDeg = 2000000000;
-	
-	for(int i = 0; i<int(sPairs.size()); i++)
-	{
-		int d = CMonomial::lcm(sPairs[i].first.HM(), sPairs[i].second.HM()).getDegree();	
-		if(d<minDeg)minDeg = d;
-	}
-	int count = 0;
-
-	for(int i = 0; i<int(sPairs.size()); i++)
-	{		
-		if(CMonomial::lcm(sPairs[i].first.HM(), sPairs[i].second.HM()).getDegree() == minDeg)
-		{		
-			count++;
-			Mark[i] = false;
-		}
-		else
-			Mark[i] = true;
-	}	
-	for(int i = 0; i<int(sPairs.size()); i++)if(!Mark[i])
+	vector<SPairSet::Row> rows;
+	const int sugar=sPairs.takeMinimal(rows);
+	ret.resize(rows.size());
+	for(size_t i=0; i!=rows.size(); ++i)
 	{
-		SPolynomial2(sPairs[i]);
-		ret.push_back(sPairs[i].first);
-		ret.push_back(sPairs[i].second);
+		ret[i].AssignMultiply(sPairs.poly(rows[i].poly), rows[i].multiplier);
 	}
-	EraseAll<SPair>(sPairs, Mark);		
+	return sugar;
 }
 
+/**данные ReduceF4(), сохраняемые между шагами F4.
+Множества мономов и непрерывно хранимые строки очищаются в начале каждого шага, а не создаются заново,
+поэтому их хеш-таблицы и массивы не выделяются на каждом шаге.
+*/
+struct ReduceF4Workspace{
+	///рабочие множества препроцессинга
+	PreprocessMonomials preprocess;
+	///старшие мономы многочленов после препроцессинга
+	MonomialMap preprocessedHM;
+	///редуцируемая матрица; её строки освобождаются в конце шага, а соответствие мономов столбцам сохраняется
+	CMatrix mainMatrix;
+	///строки матрицы при блочной декомпозиции
+	CSRMatrix mainMatrixRows;
+};
+
 /**реализация алгоритма Reduce (см теоретическую документацию).
 \param polysToReduce множество многочленов, представляющее S-пары, которое нужно редуцировать.
 Значение аргумента после возврата из процедуры неопределено (портится)
 \param reducers множество многочленов-редукторов
 \param result место для записи результата
 \param f4options параметры F4: порядок сортировки многочленов перед помещением в матрицу и параметры матричных операций.
+\param workspace данные, сохраняемые между шагами
 */
-void ReduceF4(PolynomSet& polysToReduce, PolynomSet& reducers, PolynomSet& result, const F4AlgData* f4options)
+void ReduceF4(PolynomSet& polysToReduce, PolynomSet& reducers, PolynomSet& result, const F4AlgData* f4options, ReduceF4Workspace& workspace)
 {	
 	//MEASURE_TIME_IN_BLOCK("Reduce");
-	Preprocess(polysToReduce, reducers);
+	Preprocess(polysToReduce, reducers, f4options->threadPool.get(), &workspace.preprocess);
 	
-	MonomialMap preprocessedHM;
+	MonomialMap& preprocessedHM=workspace.preprocessedHM;
+	preprocessedHM.clear();
+	preprocessedHM.reserve(polysToReduce.size());
 
 	{
 		//MEASURE_TIME_IN_BLOCK("storeMonomial");
@@ -207,7 +99,9 @@ void ReduceF4(PolynomSet& polysToReduce, PolynomSet& reducers, PolynomSet& resul
 		}
 	}
 
-	CMatrix mainMatrix;
+	CMatrix& mainMatrix=workspace.mainMatrix;
+	CSRMatrix& mainMatrixRows=workspace.mainMatrixRows;//строки матрицы при блочной декомпозиции
+	mainMatrixRows.clear();
 
 	{
 		//MEASURE_TIME_IN_BLOCK("sort");
@@ -219,18 +113,24 @@ void ReduceF4(PolynomSet& polysToReduce, PolynomSet& reducers, PolynomSet& resul
 	}
 	{
 		//MEASURE_TIME_IN_BLOCK("polyToMatrix");
-		polyToMatrix(polysToReduce, mainMatrix);
+		if(f4options->useABCDDecomposition){
+			//опорные строки не копируются в отдельные CRow
+			polyToCSRMatrix(polysToReduce, mainMatrix.getMonomialMap(), mainMatrixRows, f4options->threadPool.get());
+		}else{
+			polyToMatrix(polysToReduce, mainMatrix, f4options->threadPool.get());
+		}
 	}
 
 	{
 		//MEASURE_TIME_IN_BLOCK("reduceMatrix");
-		ReduceMatrix(mainMatrix, f4options);
+		ReduceMatrix(mainMatrix, mainMatrixRows, f4options);
 	}
 
 	{
 		//MEASURE_TIME_IN_BLOCK("matrixToPoly");
 		matrixToPoly(mainMatrix, result, preprocessedHM);
 	}
+	mainMatrix.clear();
 }
 
 
@@ -243,29 +143,29 @@ PolynomSet F4(PolynomSet F, const F4AlgData* f4options){
 	//MEASURE_TIME_IN_BLOCK("F4");
 	PolynomSet basis;
 	basis.reserve(100000);
-	SPairSet sPairs;
-	sPairs.reserve(100000);
+	SPairSet sPairs(SPairSet::Strategy(f4options->sPairSelection), f4options->sPairDegreeCap);
 	for(PolynomSet::iterator i = F.begin(); i!=F.end(); ++i)
 	{	
-		Update(basis, sPairs, *i);
+		sPairs.update(basis, *i, SPairSet::sugarOf(*i));
 	}
 	PolynomSet newBasisElements;
 	newBasisElements.reserve(100000);
 	PolynomSet sPolynomials;
 	sPolynomials.reserve(100000);
+	ReduceF4Workspace workspace;
 		
 	while(!sPairs.empty())
 	{		
 		// Selecting SPairs		
 		sPolynomials.clear();
-		SelectSPairs(sPairs, sPolynomials);
+		const int sugar = SelectSPairs(sPairs, sPolynomials);
 		
 		newBasisElements.clear();		
-		ReduceF4(sPolynomials, basis, newBasisElements, f4options);		
+		ReduceF4(sPolynomials, basis, newBasisElements, f4options, workspace);		
 		sort(newBasisElements.begin(),newBasisElements.end(),cmpForUpdaters);
 		// Updating basis and sPairs
 		for(const auto& newBasisElement: newBasisElements)
-			Update(basis, sPairs, newBasisElement);
+			sPairs.update(basis, newBasisElement, sugar);
 		
 	}
 	if(f4options->autoReduceBasis){
@@ -188,7 +188,7 @@ struct F5Data
 private:
 	vector<RuleItem> rulesCurrent;
 	vector<vector<CMonomial>> rulesOld;
-	vector<CMonomial> prevBasisTops;
+	DivisorIndex prevBasisTops;
 	bool checkOldReducer(int polyInBasis, const CMonomial& mon)const
 	{
 		//cout << "checkOldReducer running for  " << mon.toString() << " polyIdx = " << polyInBasis << " poly = ";
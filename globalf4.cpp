@@ -6,9 +6,11 @@
 #include "globalf4.h"
 #include "cmodular.h"
 #include "parse.tab.h"
+#include "monomialtable.h"
 
 namespace globalF4MPI{
 	MemoryManager MonomialAllocator;
+	MonomialTable InternedMonomials;
 //	PolynomMap globalPolynomMap;
 
 	GlobalOptions globalOptions;
@@ -16,13 +18,14 @@ namespace globalF4MPI{
 	void InitializeGlobalOptions(){
 		CMonomial::setOrder((CMonomial::Order)globalOptions.monomOrder, globalOptions.monomOrderParam);
 		CModular::setMOD(globalOptions.mod);
-		CMonomial::setNumberOfVariables(globalOptions.numberOfVariables);
+		CMonomial::setNumberOfVariables(globalOptions.numberOfVariables, globalOptions.degreeBytes, globalOptions.sparseTerms);
 		globalF4MPI::MonomialAllocator.setSize(CMonomial::degreessize);
-		PODvecSize<CInternalMonomial>::setvalsize(CMonomial::degreessize);
 		MonomialAllocator.reset();
+		InternedMonomials.reset();
 	}
 	void Finalize(){
 		MonomialAllocator.reset();
+		InternedMonomials.reset();
 	}
 }
 
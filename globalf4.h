@@ -20,6 +20,8 @@ namespace globalF4MPI{
 		int mod;///<модуль по которому идут вычисления CModular
 		int monomOrder;///<код порядка на мономах
 		int monomOrderParam;///<параметр порядка на мономах
+		int degreeBytes = 1;///<число байт на степень в мономе (1, 2 или 4), см. CMonomialBase::degreeBytes
+		int sparseTerms = 0;///<ёмкость разреженных мономов или 0 для плотных, см. CMonomialBase::sparseTerms
 	};
 
 	///центральная "точка доступа" к глобальным парметрам
@@ -28,14 +30,14 @@ namespace globalF4MPI{
 	/**Инициализация глобальных переменных.
 	после определения в парсере или получения от главного процесса,
 	глобальные опции нужно сообщить всем классам, поведение которых от них зависит.
-	Особенно важно установить правильный размер памяти, занимаемый данными монома - это нужно сделать и как
-	в аллокаторе MonomialAllocator для отдельных мономов, так и в классе PODvecSize\<CInternalMonomial\> который хранит масивы мономов в многочленах.
+	Особенно важно установить правильный размер памяти, занимаемый данными монома, в аллокаторе MonomialAllocator
+	для отдельных мономов и очистить таблицу InternedMonomials, в которой хранятся мономы многочленов.
 	*/
 
 	void InitializeGlobalOptions();
 
 	/**Деннициализация глобальных ресурсов.
-	Освобождает всю память, выделенную аллокатором #MonomialAllocator.
+	Освобождает всю память, выделенную аллокатором #MonomialAllocator и таблицей мономов InternedMonomials.
 	Это нужно делать отдельно, т.к. после удаления мономов память не освобождается, а складыывается в пул.
 	*/
 	void Finalize();
@@ -22,6 +22,9 @@
 #include <cstring>
 #include <cerrno>
 #include <memory>
+#include <iterator>
+#include <algorithm>
+#include <limits>
 using namespace std;
 namespace F4MPI{
 
@@ -39,7 +42,14 @@ F4OptForStatsDescription optionsDescription[]={
 	{"Inner loop block size       ", &F4AlgData::innerGaussBlockSize},
 	{"MPI block size              ", &F4AlgData::MPIBlockSize},
 	{"MPI use big sends           ", &F4AlgData::MPIUseBigSends},
-	{"Use sizes for selecting row ", &F4AlgData::useSizesForSelectingRow}
+	{"Use sizes for selecting row ", &F4AlgData::useSizesForSelectingRow},
+	{"Use ABCD decomposition      ", &F4AlgData::useABCDDecomposition},
+	{"Use dense accumulator       ", &F4AlgData::useDenseAccumulator},
+	{"Number of threads           ", &F4AlgData::numberOfThreads},
+	{"Dense block filling, %      ", &F4AlgData::denseBlockFilling},
+	{"Use bit-packed GF(2) engine ", &F4AlgData::useGF2Engine},
+	{"S-pair selection strategy   ", &F4AlgData::sPairSelection},
+	{"S-pair degree cap           ", &F4AlgData::sPairDegreeCap}
 //	{"matrixSheduler", &CMatrix::matrixSheduler},
 //	{"MPIProcessCirculation", &MPI_PROCESS_CIRCULATE_ORDER},
 };
@@ -54,6 +64,105 @@ LibF4ReturnCode MPICheckResult(LibF4ReturnCode result=LIBF4_NO_ERROR, int root=0
 	return result;
 }
 
+///число байт, занимаемых степенями плотного монома от \a n переменных при ширине степени \a degreeBytes (см. CMonomialBase::degreeWords)
+int denseDegreesSize(int n, int degreeBytes){
+	const int degsPerWord=sizeof(CMonomialBase::DegWord)/degreeBytes;
+	return (n+degsPerWord)/degsPerWord*sizeof(CMonomialBase::DegWord);
+}
+
+///число байт, занимаемых степенями разреженного монома ёмкости \a terms (см. CMonomialBase::sparseTerms)
+int sparseDegreesSize(int terms){
+	return sizeof(CMonomialBase::DegWord)+terms*sizeof(uint32_t);
+}
+
+/**увеличивает ширину степеней мономов для следующей попытки разбора и вычисления.
+Ёмкость разреженных мономов удваивается, пока они короче плотных мономов с 16-битными степенями, после чего мономы становятся плотными.
+\retval false если ширина уже наибольшая
+*/
+bool widenMonomialDegrees(){
+	globalF4MPI::GlobalOptions& options=globalF4MPI::globalOptions;
+	if (options.sparseTerms){
+		options.sparseTerms*=2;
+		if (options.sparseTerms>CMonomialBase::sparseMaxTerms || sparseDegreesSize(options.sparseTerms)>=denseDegreesSize(options.numberOfVariables, options.degreeBytes)){
+			options.sparseTerms=0;
+		}
+		return true;
+	}
+	if (options.degreeBytes>=4) return false;
+	options.degreeBytes*=2;
+	return true;
+}
+
+/**Выбор разреженных мономов (см. CMonomialBase::sparseTerms) для разобранной задачи \a givenSet степени \a inputDegree.
+Ёмкость берётся вчетверо больше наибольшего числа переменных входного монома, поскольку в НОК и произведениях переменных больше.
+Разреженные мономы выбираются, только если они хотя бы вдвое короче плотных и их 16-битных степеней достаточно для задачи.
+\retval ёмкость разреженных мономов или 0, если мономы должны остаться плотными
+*/
+int chooseSparseTerms(const PolynomSet& givenSet, int inputDegree){
+	const globalF4MPI::GlobalOptions& options=globalF4MPI::globalOptions;
+	if (2*int64_t(inputDegree)>numeric_limits<int16_t>::max()) return 0;
+	int support=0;
+	for (const auto& poly: givenSet){
+		for (auto mon=poly.m_begin(); mon!=poly.m_end(); ++mon){
+			int monSupport=0;
+			for (int i=0;i<options.numberOfVariables;++i){
+				if (mon->getDegree(i)) ++monSupport;
+			}
+			support=max(support, monSupport);
+		}
+	}
+	const int terms=max(8, 4*support);
+	if (terms>CMonomialBase::sparseMaxTerms) return 0;
+	return 2*sparseDegreesSize(terms)<=denseDegreesSize(options.numberOfVariables, options.degreeBytes) ? terms : 0;
+}
+
+///описание текущего представления мономов для вывода
+string monomialRepresentationName(){
+	const globalF4MPI::GlobalOptions& options=globalF4MPI::globalOptions;
+	if (options.sparseTerms) return "sparse monomials of up to "+to_string(options.sparseTerms)+" variables";
+	return to_string(8*options.degreeBytes)+"-bit degrees";
+}
+
+/**Разбор задачи с выбором ширины степеней.
+Разбирает задачу из \a text, начиная с текущей ширины степеней globalOptions.degreeBytes.
+Ширина увеличивается, если степени при разборе не поместились, или если НОК двух старших мономов входных многочленов
+может превысить CMonomialBase::maxDegree (тогда вычисление остановилось бы на первом же S-полиноме).
+При \a allowSparse задача с многими переменными и короткими мономами разбирается заново в разреженные мономы (см. chooseSparseTerms()).
+*/
+LibF4ReturnCode parseChoosingDegreeWidth(const string& text, PolynomSet& givenSet, ParserVarNames& varNames, bool allowSparse){
+	for(;;){
+		givenSet.clear();
+		istringstream input(text);
+		try{
+			LibF4ReturnCode result=LibF4ReturnCode(ParseInput(input, givenSet, &varNames));
+			if (result<0) return result;
+			int inputDegree=0;
+			for (const auto& poly: givenSet){
+				for (auto mon=poly.m_begin(); mon!=poly.m_end(); ++mon){
+					inputDegree=max(inputDegree, mon->getDegree());
+				}
+			}
+			if (2*int64_t(inputDegree)<=CMonomialBase::maxDegree){
+				const int sparseTerms=allowSparse ? chooseSparseTerms(givenSet, inputDegree) : 0;
+				if (!sparseTerms) return result;
+				allowSparse=false;
+				globalF4MPI::globalOptions.sparseTerms=sparseTerms;
+				globalF4MPI::globalOptions.degreeBytes=2;
+				givenSet.clear();
+				continue;
+			}
+			givenSet.clear();
+			if (!widenMonomialDegrees()) return result;
+		}catch(const DegreeOverflow& e){
+			givenSet.clear();
+			if (!widenMonomialDegrees()){
+				fprintf(stderr, "Parse error: %s\n", e.what());
+				return LIBF4_ERR_PARSE_FAILED;
+			}
+		}
+	}
+}
+
 /**вычисление базиса из потока.
 Считывает задачу из \a input, вычисляет базис с параметрами f4givenOptions и записывает полученный базис в строку \a output.
 При ненулевых параметрах статистика по матрицам собирается в \a f4stats, а по времени записывается в файл \a stats.
@@ -66,8 +175,13 @@ LibF4ReturnCode runF4FromStream(istream& input, ostream& output, F4AlgOptions& f
 	PolynomSet givenSet;
 	ParserVarNames varNames;
 	LibF4ReturnCode parseSuccess=LIBF4_NO_ERROR;
+	//текст задачи сохраняется, чтобы при переполнении степеней разобрать его заново с большей шириной степеней
+	string inputText;
 	if (mpi_start_info.isMainProcess()){
-		parseSuccess=LibF4ReturnCode(ParseInput(input, givenSet, &varNames));
+		inputText.assign(istreambuf_iterator<char>(input), istreambuf_iterator<char>());
+		globalF4MPI::globalOptions.degreeBytes=1;
+		globalF4MPI::globalOptions.sparseTerms=0;
+		parseSuccess=parseChoosingDegreeWidth(inputText, givenSet, varNames, true);
 		if(f4data.showInfoToStdout){
 			if (parseSuccess>=0){
 				string varDesc;
@@ -87,10 +201,18 @@ LibF4ReturnCode runF4FromStream(istream& input, ostream& output, F4AlgOptions& f
 							globalF4MPI::globalOptions.monomOrderParam
 						);
 				}
+				printf(", %s",
+						monomialRepresentationName().c_str()
+					);
 				printf("\n");
 				printf("Using %d processes\n",
 						mpi_start_info.numberOfProcs
 					);
+				if (f4data.threadPool){
+					printf("Using %d threads per process\n",
+							f4data.threadPool->size()
+						);
+				}
 			}
 			fflush(stdout);
 		}
@@ -123,7 +245,24 @@ LibF4ReturnCode runF4FromStream(istream& input, ostream& output, F4AlgOptions& f
 	
 	//Выполнение алгоритма F4
 	if (mpi_start_info.isMainProcess()){
-		basis = GB(givenSet, &f4data);
+		for(;;){
+			try{
+				basis = GB(givenSet, &f4data);
+				break;
+			}catch(const DegreeOverflow& e){
+				//все мономы вычисления к этому моменту уничтожены, поэтому можно сменить их представление и начать заново
+				if (!widenMonomialDegrees()) throw;
+				if (f4data.showInfoToStdout){
+					printf("%s\nRestarting with %s\n", e.what(), monomialRepresentationName().c_str());
+					fflush(stdout);
+				}
+				//статистика прерванной попытки не относится к результату
+				ostream* matrixInfoFile=f4stats->matrixInfoFile;
+				*f4stats=F4Stats();
+				f4stats->matrixInfoFile=matrixInfoFile;
+				if (parseChoosingDegreeWidth(inputText, givenSet, varNames, false)<0) throw;
+			}
+		}
 #if WITH_MPI
 		int finished=true;
 		MPI_Bcast(&finished,1,MPI_INT,0,MPI_COMM_WORLD);
@@ -276,4 +415,11 @@ void initDefaultF4Options(F4AlgOptions* opts){
 	opts->showInfoToStdout=0;
 	opts->generateLatexLog=0;
 	opts->selectedAlgo=0;
+	opts->useABCDDecomposition=0;
+	opts->useDenseAccumulator=0;
+	opts->numberOfThreads=1;
+	opts->denseBlockFilling=30;
+	opts->useGF2Engine=1;
+	opts->sPairSelection=0;
+	opts->sPairDegreeCap=0;
 }
@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+#include "bitmatrix.h"
+#include <vector>
+#include <cstdint>
+using namespace F4MPI;
+
+namespace{
+typedef std::vector<std::vector<bool>> Rows;
+
+//простой метод Гаусса-Жордана над GF(2): ненулевые строки сильно ступенчатого вида по возрастанию ведущего столбца
+Rows referenceReducedForm(Rows a)
+{
+	Rows result;
+	const int columns = a.empty() ? 0 : a[0].size();
+	for (int c = 0; c < columns; ++c){
+		int r = 0;
+		while (r < int(a.size()) && !a[r][c]) ++r;
+		if (r == int(a.size())) continue;
+		std::vector<bool> pivot = a[r];
+		a.erase(a.begin() + r);
+		for (auto* rows: {&a, &result}){
+			for (auto& row: *rows){
+				if (!row[c]) continue;
+				for (int j = 0; j < columns; ++j) row[j] = row[j] != pivot[j];
+			}
+		}
+		result.push_back(pivot);
+	}
+	return result;
+}
+}
+
+TEST(BitMatrix, reducedFormMatchesReference)
+{
+	uint64_t x = 88172645463325252ull;
+	ThreadPool pool(3);
+	for (int size: {1, 10, 63, 150}){
+		const int rows = size + 5, columns = 2 * size + 3;
+		Rows a(rows, std::vector<bool>(columns));
+		for (int i = 0; i < rows; ++i){
+			for (int j = 0; j < columns; ++j){
+				x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+				a[i][j] = (x >> 40) % 4 == 0;
+			}
+			//линейно зависимые строки дают нулевые строки
+			if (i % 5 == 4){
+				for (int j = 0; j < columns; ++j) a[i][j] = a[i - 1][j] != a[i - 2][j];
+			}
+		}
+		const Rows expected = referenceReducedForm(a);
+		for (ThreadPool* usedPool: {(ThreadPool*)0, &pool}){
+			BitMatrix m(rows, columns);
+			for (int i = 0; i < rows; ++i){
+				for (int j = 0; j < columns; ++j) if (a[i][j]) m.set(i, j);
+			}
+			const int rank = m.rowEchelonForm(true, usedPool);
+			ASSERT_EQ(rank, int(expected.size())) << "size " << size;
+			for (const auto& row: expected){
+				int found = -1;
+				for (int i = 0; i < rank; ++i){
+					bool same = true;
+					for (int j = 0; j < columns; ++j) same = same && m.get(i, j) == row[j];
+					if (same) found = i;
+				}
+				EXPECT_GE(found, 0) << "size " << size;
+			}
+			for (int i = rank; i < rows; ++i){
+				for (int w = 0; w < m.rowWords(); ++w) EXPECT_EQ(m.row(i)[w], 0u);
+			}
+		}
+	}
+}
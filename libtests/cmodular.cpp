@@ -1,9 +1,33 @@
 #include <gtest/gtest.h>
 #include "cmodular.h"
+#include "modpolicy.h"
 using namespace F4MPI;
 TEST(CModular, eq)
 {
 	CModular m1(1000);
 	CModular m2(1000);
 	EXPECT_EQ(m1,m2);
-}
\ No newline at end of file
+}
+TEST(CModular, modulusPolicies)
+{
+	const uint32_t moduli[] = {2, 3, 31013, 65521, 65537, 2147483647u, 4294967291u};
+	uint64_t x = 88172645463325252ull;
+	for (uint32_t p: moduli){
+		BarrettModulus barrett(p);
+		EXPECT_EQ(barrett.reduce(0), 0u);
+		EXPECT_EQ(barrett.reduce(~uint64_t(0)), uint32_t(~uint64_t(0) % p)) << p;
+		for (int i = 0; i < 1000; ++i){
+			x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+			ASSERT_EQ(barrett.reduce(x), uint32_t(x % p)) << x << " mod " << p;
+		}
+	}
+	FixedModulus<31013> fixed;
+	CModular::setMOD(31013);
+	for (int a = 0; a < 31013; a += 97){
+		for (int b = 1; b < 31013; b += 1013){
+			EXPECT_EQ(fixed.mul(CModular(a), CModular(b)), CModular(a) * CModular(b));
+			EXPECT_EQ(fixed.mulAdd(CModular(b), CModular(a), CModular(b)), CModular(b) + CModular(a) * CModular(b));
+			EXPECT_EQ(fixed.add(fixed.neg(CModular(a)), CModular(a)), CModular(0));
+		}
+	}
+}
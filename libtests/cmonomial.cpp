@@ -0,0 +1,464 @@
+#include <gtest/gtest.h>
+#include "cmonomial.h"
+#include "globalf4.h"
+#include "monomialtable.h"
+#include "monomialmap.h"
+#include "conversions.h"
+#include "threadpool.h"
+#include <algorithm>
+#include <vector>
+#include <cstdint>
+using namespace F4MPI;
+
+namespace{
+void InitMonomials(int variables, int degreeBytes = 1, CMonomialBase::Order order = CMonomialBase::degrevlexOrder, int orderParam = 0, int sparseTerms = 0)
+{
+	globalF4MPI::globalOptions.degreeBytes = degreeBytes;
+	globalF4MPI::globalOptions.sparseTerms = sparseTerms;
+	globalF4MPI::globalOptions.numberOfVariables = variables;
+	globalF4MPI::globalOptions.mod = 31013;
+	globalF4MPI::globalOptions.monomOrder = order;
+	globalF4MPI::globalOptions.monomOrderParam = orderParam;
+	globalF4MPI::InitializeGlobalOptions();
+}
+
+//при широких степенях степени умножаются на \a scale, чтобы выйти за пределы 8 бит
+CMonomial RandomMonomial(int variables, uint64_t& x, int scale = 1)
+{
+	std::vector<CMonomialBase::Deg> degrees(variables);
+	int total;
+	do{
+		total = 0;
+		for (auto& d: degrees){
+			x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+			//в основном малые степени, иногда превышающие число битов маски на переменную
+			d = scale * ((x >> 20) % 4 ? (x >> 30) % 2 : (x >> 40) % 6);
+			total += d;
+		}
+	//произведения и НОК должны оставаться в пределах maxDegree
+	}while (2 * int64_t(total) > CMonomialBase::maxDegree);
+	return CMonomial(degrees);
+}
+
+bool DivisibleByDegrees(const CMonomial& a, const CMonomial& b, int variables)
+{
+	for (int i = 0; i < variables; ++i){
+		if (a.getDegree(i) < b.getDegree(i)) return false;
+	}
+	return true;
+}
+}
+
+//маска делимости не должна менять результат проверок делимости ни при каком числе переменных
+TEST(CMonomial, divisibilityWithMasks)
+{
+	uint64_t x = 88172645463325252ull;
+	for (int variables: {1, 3, 10, 32, 40}){
+		InitMonomials(variables);
+		std::vector<CMonomial> monomials;
+		for (int i = 0; i < 60; ++i) monomials.push_back(RandomMonomial(variables, x));
+		for (const auto& a: monomials){
+			for (const auto& b: monomials){
+				const bool expected = DivisibleByDegrees(a, b, variables);
+				ASSERT_EQ(a.divisibleBy(b), expected) << a.toString() << " / " << b.toString();
+				CMonomial quotient;
+				ASSERT_EQ(a.tryDivide(b, quotient), expected);
+				if (!expected) continue;
+				//маска частного пересчитывается: произведение снова совпадает с делимым и делится на оба множителя
+				EXPECT_TRUE(quotient * b == a);
+				EXPECT_TRUE(a.divisibleBy(quotient));
+				EXPECT_TRUE((quotient * b).divisibleBy(a));
+				CMonomial lcm = CMonomial::lcm(a, b);
+				EXPECT_TRUE(lcm.divisibleBy(a) && lcm.divisibleBy(b));
+			}
+		}
+	}
+	globalF4MPI::Finalize();
+}
+
+namespace{
+//сравнение степеней [from;to) по degrevlex
+int CompareBlockByDegrees(const CMonomial& a, const CMonomial& b, int from, int to)
+{
+	int da = 0, db = 0;
+	for (int i = from; i < to; ++i){
+		da += a.getDegree(i);
+		db += b.getDegree(i);
+	}
+	if (da != db) return da > db ? 1 : -1;
+	for (int i = to - 1; i >= from; --i){
+		if (a.getDegree(i) != b.getDegree(i)) return a.getDegree(i) < b.getDegree(i) ? 1 : -1;
+	}
+	return 0;
+}
+
+int CompareByDegrees(const CMonomial& a, const CMonomial& b, int variables, CMonomialBase::Order order, int orderParam = 0)
+{
+	if (order == CMonomialBase::blklexOrder){
+		const int res = CompareBlockByDegrees(a, b, 0, orderParam);
+		return res ? res : CompareBlockByDegrees(a, b, orderParam, variables);
+	}
+	if (order != CMonomialBase::lexOrder && a.getDegree() != b.getDegree()) return a.getDegree() > b.getDegree() ? 1 : -1;
+	for (int k = 0; k < variables; ++k){
+		const int i = order == CMonomialBase::degrevlexOrder ? variables - 1 - k : k;
+		const int dif = a.getDegree(i) - b.getDegree(i);
+		if (dif) return (order == CMonomialBase::degrevlexOrder) == (dif < 0) ? 1 : -1;
+	}
+	return 0;
+}
+}
+
+//упакованные в слова операции должны совпадать с поэлементными, в том числе на границах слов, при любой ширине степеней
+TEST(CMonomial, packedOperationsMatchDegrees)
+{
+	uint64_t x = 88172645463325252ull;
+	for (int degreeBytes: {1, 2, 4})
+	for (int variables: {1, 3, 4, 6, 7, 8, 9, 15, 16, 17}){
+		InitMonomials(variables, degreeBytes);
+		std::vector<CMonomial> monomials;
+		for (int i = 0; i < 40; ++i) monomials.push_back(RandomMonomial(variables, x, degreeBytes == 1 ? 1 : 1000));
+		for (const auto& a: monomials){
+			for (const auto& b: monomials){
+				for (auto order: {CMonomialBase::lexOrder, CMonomialBase::deglexOrder, CMonomialBase::degrevlexOrder}){
+					ASSERT_EQ(a.compareTo(b, order), CompareByDegrees(a, b, variables, order)) << a.toString() << " ? " << b.toString() << " order " << order;
+				}
+				const CMonomial product = a * b, gcd = CMonomial::gcd(a, b), lcm = CMonomial::lcm(a, b);
+				for (int i = 0; i < variables; ++i){
+					ASSERT_EQ(product.getDegree(i), a.getDegree(i) + b.getDegree(i));
+					ASSERT_EQ(gcd.getDegree(i), std::min(a.getDegree(i), b.getDegree(i)));
+					ASSERT_EQ(lcm.getDegree(i), std::max(a.getDegree(i), b.getDegree(i)));
+				}
+				EXPECT_EQ(product.getDegree(), a.getDegree() + b.getDegree());
+				EXPECT_EQ(a == b, CompareByDegrees(a, b, variables, CMonomialBase::lexOrder) == 0);
+			}
+		}
+	}
+	globalF4MPI::Finalize();
+}
+
+//экземпляры для 1, 2 и 4 слов и общий экземпляр должны давать одинаковые результаты; 3 слова округляются до 4
+TEST(CMonomial, wordDispatchMatchesDegrees)
+{
+	uint64_t x = 88172645463325252ull;
+	//от большего числа слов к меньшему: память мономов переиспользуется, и неиспользуемые степени в словах должны обнуляться
+	const std::pair<int, int> wordsOfVariables[] = {{39, 5}, {32, 5}, {31, 4}, {23, 4}, {20, 4}, {16, 4}, {15, 2}, {8, 2}, {7, 1}};
+	for (const auto& vw: wordsOfVariables){
+		const int variables = vw.first;
+		InitMonomials(variables);
+		ASSERT_EQ(CMonomialBase::degreeWords, vw.second) << variables << " variables";
+		std::vector<CMonomial> monomials;
+		for (int i = 0; i < 30; ++i) monomials.push_back(RandomMonomial(variables, x));
+		for (const auto& a: monomials){
+			EXPECT_TRUE(a * CMonomial() == a);
+			EXPECT_TRUE(CMonomial(std::vector<CMonomialBase::Deg>(variables)) == CMonomial());
+		}
+		for (const auto& a: monomials){
+			for (const auto& b: monomials){
+				for (auto order: {CMonomialBase::lexOrder, CMonomialBase::deglexOrder, CMonomialBase::degrevlexOrder}){
+					ASSERT_EQ(a.compareTo(b, order), CompareByDegrees(a, b, variables, order)) << a.toString() << " ? " << b.toString() << " order " << order;
+				}
+				ASSERT_EQ(a.divisibleBy(b), DivisibleByDegrees(a, b, variables));
+				const CMonomial product = a * b, gcd = CMonomial::gcd(a, b), lcm = CMonomial::lcm(a, b);
+				for (int i = 0; i < variables; ++i){
+					ASSERT_EQ(product.getDegree(i), a.getDegree(i) + b.getDegree(i));
+					ASSERT_EQ(gcd.getDegree(i), std::min(a.getDegree(i), b.getDegree(i)));
+					ASSERT_EQ(lcm.getDegree(i), std::max(a.getDegree(i), b.getDegree(i)));
+				}
+				EXPECT_EQ(gcd.getDegree() + lcm.getDegree(), a.getDegree() + b.getDegree());
+				EXPECT_TRUE(product == CMonomial(product));
+			}
+		}
+	}
+	globalF4MPI::Finalize();
+}
+
+//переполнение степени сообщается исключением DegreeOverflow; при большей ширине те же мономы допустимы
+TEST(CMonomial, degreeOverflowDependsOnWidth)
+{
+	InitMonomials(2);
+	const CMonomial a(std::vector<CMonomialBase::Deg>{60, 0});
+	EXPECT_THROW(a * a, DegreeOverflow);
+	EXPECT_THROW(CMonomial(std::vector<CMonomialBase::Deg>{200, 0}), DegreeOverflow);
+	InitMonomials(2, 2);
+	const CMonomial b(std::vector<CMonomialBase::Deg>{200, 0});
+	EXPECT_EQ((b * b).getDegree(0), 400);
+	EXPECT_EQ(CMonomial::lcm(b, CMonomial(std::vector<CMonomialBase::Deg>{1, 300})).getDegree(), 500);
+	InitMonomials(2, 4);
+	const CMonomial c(std::vector<CMonomialBase::Deg>{100000, 7});
+	EXPECT_EQ((c * c).getDegree(), 200014);
+	EXPECT_TRUE((c * c).divisibleBy(c));
+	InitMonomials(2);
+	globalF4MPI::Finalize();
+}
+
+namespace{
+//хеш монома, построенного заново по степеням переменных
+size_t HashByDegrees(const CMonomial& m, int variables)
+{
+	std::vector<CMonomialBase::Deg> degrees(variables);
+	for (int i = 0; i < variables; ++i) degrees[i] = m.getDegree(i);
+	return CMonomial(degrees).hash();
+}
+}
+
+//хранимый хеш линеен и после любых операций совпадает с хешем того же монома, вычисленным по степеням
+TEST(CMonomial, incrementalHash)
+{
+	uint64_t x = 88172645463325252ull;
+	for (int degreeBytes: {1, 2, 4})
+	for (int variables: {1, 7, 8, 17, 40}){
+		InitMonomials(variables, degreeBytes);
+		std::vector<CMonomial> monomials;
+		for (int i = 0; i < 30; ++i) monomials.push_back(RandomMonomial(variables, x, degreeBytes == 1 ? 1 : 1000));
+		EXPECT_EQ(CMonomial().hash(), HashByDegrees(CMonomial(), variables));
+		for (const auto& a: monomials){
+			ASSERT_EQ(a.hash(), HashByDegrees(a, variables)) << a.toString();
+			for (const auto& b: monomials){
+				const CMonomial product = a * b;
+				ASSERT_EQ(product.hash(), a.hash() + b.hash()) << a.toString() << " * " << b.toString();
+				ASSERT_EQ(product.hash(), HashByDegrees(product, variables));
+				CMonomial m = a;
+				m *= b;
+				EXPECT_EQ(m.hash(), product.hash());
+				CMonomial quotient;
+				ASSERT_TRUE(product.tryDivide(b, quotient));
+				EXPECT_EQ(quotient.hash(), a.hash());
+				EXPECT_EQ(CMonomial::gcd(a, b).hash(), HashByDegrees(CMonomial::gcd(a, b), variables));
+				EXPECT_EQ(CMonomial::lcm(a, b).hash(), HashByDegrees(CMonomial::lcm(a, b), variables));
+				if (!(a == b)) { EXPECT_NE(a.hash(), b.hash()) << a.toString() << " " << b.toString(); }
+			}
+		}
+	}
+	globalF4MPI::Finalize();
+}
+
+//ключи порядка, в том числе пересчитанные при умножении и делении, упорядочивают мономы так же, как степени, при любом порядке
+TEST(CMonomial, orderKeysMatchOrder)
+{
+	uint64_t x = 88172645463325252ull;
+	for (int degreeBytes: {1, 2, 4})
+	for (int variables: {1, 3, 7, 8, 9, 17})
+	for (auto order: {CMonomialBase::lexOrder, CMonomialBase::deglexOrder, CMonomialBase::degrevlexOrder, CMonomialBase::blklexOrder}){
+		const int orderParam = order == CMonomialBase::blklexOrder ? variables / 2 : 0;
+		InitMonomials(variables, degreeBytes, order, orderParam);
+		std::vector<CMonomial> monomials;
+		for (int i = 0; i < 25; ++i) monomials.push_back(RandomMonomial(variables, x, degreeBytes == 1 ? 1 : 1000));
+		for (const auto& a: monomials){
+			for (const auto& b: monomials){
+				ASSERT_EQ(a.compareTo(b), CompareByDegrees(a, b, variables, order, orderParam)) << a.toString() << " ? " << b.toString() << " order " << order;
+				if (a.orderKey() != b.orderKey()) { EXPECT_EQ(a.orderKey() > b.orderKey(), a.compareTo(b) > 0); }
+				const CMonomial product = a * b;
+				CMonomial quotient;
+				ASSERT_TRUE(product.tryDivide(b, quotient));
+				EXPECT_EQ(quotient.orderKey(), a.orderKey());
+				for (const CMonomial& m: {product, CMonomial::gcd(a, b), CMonomial::lcm(a, b)}){
+					//ключ, пересчитанный операцией, совпадает с ключом того же монома, построенного по степеням
+					std::vector<CMonomialBase::Deg> degrees(variables);
+					for (int i = 0; i < variables; ++i) degrees[i] = m.getDegree(i);
+					ASSERT_EQ(m.orderKey(), CMonomial(degrees).orderKey()) << m.toString();
+					EXPECT_EQ(m.compareTo(a), CompareByDegrees(m, a, variables, order, orderParam));
+				}
+			}
+		}
+	}
+	InitMonomials(2);
+	globalF4MPI::Finalize();
+}
+
+namespace{
+//моном от многих переменных, лишь несколько из которых имеют ненулевую степень
+CMonomial RandomSparseMonomial(int variables, uint64_t& x)
+{
+	std::vector<CMonomialBase::Deg> degrees(variables);
+	for (int k = 0; k < 4; ++k){
+		x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+		degrees[(x >> 20) % variables] += (x >> 40) % 3;
+	}
+	return CMonomial(degrees);
+}
+}
+
+//разреженные мономы согласованы со степенями переменных при любом порядке, а лишние переменные дают DegreeOverflow
+TEST(CMonomial, sparseMonomials)
+{
+	uint64_t x = 88172645463325252ull;
+	const int variables = 150;
+	for (auto order: {CMonomialBase::lexOrder, CMonomialBase::deglexOrder, CMonomialBase::degrevlexOrder, CMonomialBase::blklexOrder}){
+		const int orderParam = order == CMonomialBase::blklexOrder ? 60 : 0;
+		InitMonomials(variables, 2, order, orderParam, 16);
+		ASSERT_EQ(CMonomialBase::sparseTerms, 16);
+		std::vector<CMonomial> monomials;
+		for (int i = 0; i < 40; ++i) monomials.push_back(RandomSparseMonomial(variables, x));
+		for (const auto& a: monomials){
+			ASSERT_EQ(a.hash(), HashByDegrees(a, variables)) << a.toString();
+			for (const auto& b: monomials){
+				ASSERT_EQ(a.compareTo(b), CompareByDegrees(a, b, variables, order, orderParam)) << a.toString() << " ? " << b.toString() << " order " << order;
+				EXPECT_EQ(a == b, CompareByDegrees(a, b, variables, CMonomialBase::lexOrder) == 0);
+				EXPECT_EQ(a.divisibleBy(b), DivisibleByDegrees(a, b, variables)) << a.toString() << " / " << b.toString();
+				const CMonomial product = a * b, gcd = CMonomial::gcd(a, b), lcm = CMonomial::lcm(a, b);
+				for (int i = 0; i < variables; ++i){
+					ASSERT_EQ(product.getDegree(i), a.getDegree(i) + b.getDegree(i));
+					ASSERT_EQ(gcd.getDegree(i), std::min(a.getDegree(i), b.getDegree(i)));
+					ASSERT_EQ(lcm.getDegree(i), std::max(a.getDegree(i), b.getDegree(i)));
+				}
+				EXPECT_EQ(product.getDegree(), a.getDegree() + b.getDegree());
+				EXPECT_EQ(product.hash(), a.hash() + b.hash());
+				CMonomial quotient;
+				ASSERT_TRUE(product.tryDivide(b, quotient));
+				EXPECT_TRUE(quotient == a);
+				for (const CMonomial& m: {product, gcd, lcm}){
+					std::vector<CMonomialBase::Deg> degrees(variables);
+					for (int i = 0; i < variables; ++i) degrees[i] = m.getDegree(i);
+					const CMonomial byDegrees(degrees);
+					ASSERT_TRUE(m == byDegrees) << m.toString();
+					EXPECT_EQ(m.hash(), byDegrees.hash());
+					EXPECT_EQ(m.orderKey(), byDegrees.orderKey());
+				}
+			}
+		}
+		std::vector<CMonomialBase::Deg> first(variables), second(variables);
+		for (int i = 0; i < 9; ++i){
+			first[2 * i] = 1;
+			second[2 * i + 1] = 1;
+		}
+		const CMonomial a(first), b(second);
+		EXPECT_THROW(a * b, DegreeOverflow);
+		EXPECT_THROW(CMonomial::lcm(a, b), DegreeOverflow);
+		EXPECT_TRUE(CMonomial::gcd(a, b).isOne());
+	}
+	InitMonomials(2);
+	globalF4MPI::Finalize();
+}
+
+//одинаковые мономы получают один номер, произведения по номерам совпадают с обычными
+TEST(CMonomial, internedMonomials)
+{
+	uint64_t x = 88172645463325252ull;
+	for (int variables: {3, 17}){
+		InitMonomials(variables);
+		MonomialTable& table = globalF4MPI::InternedMonomials;
+		std::vector<CMonomial> monomials;
+		std::vector<MonomialID> ids;
+		for (int i = 0; i < 300; ++i){
+			monomials.push_back(RandomMonomial(variables, x));
+			ids.push_back(table.intern(monomials.back()));
+		}
+		for (size_t i = 0; i < monomials.size(); ++i){
+			ASSERT_TRUE(table.get(ids[i]) == monomials[i]);
+			ASSERT_EQ(table.find(monomials[i]), ids[i]);
+			for (size_t j = 0; j < monomials.size(); j += 7){
+				ASSERT_EQ(ids[i] == ids[j], monomials[i] == monomials[j]);
+				//второе умножение берётся из кеша произведений
+				for (int repeat = 0; repeat < 2; ++repeat){
+					ASSERT_TRUE(table.get(table.mul(ids[i], ids[j])) == monomials[i] * monomials[j]);
+				}
+			}
+		}
+		const size_t interned = table.size();
+		//суммарная степень случайных мономов не больше maxDegree/2
+		std::vector<CMonomialBase::Deg> absent(variables, 0);
+		absent[0] = CMonomialBase::maxDegree;
+		EXPECT_EQ(table.find(CMonomial(absent)), MonomialTable::noMonomial);
+		EXPECT_EQ(table.size(), interned);
+	}
+	InitMonomials(3);
+	EXPECT_EQ(globalF4MPI::InternedMonomials.size(), 0u);
+	globalF4MPI::Finalize();
+}
+
+//удаление из хеш-таблицы с открытой адресацией не должно терять соседние мономы
+TEST(MonomialMap, storeEraseAndOrder)
+{
+	uint64_t x = 88172645463325252ull;
+	InitMonomials(6);
+	std::vector<MonomialID> ids;
+	for (int i = 0; i < 2000; ++i){
+		ids.push_back(globalF4MPI::InternedMonomials.intern(RandomMonomial(6, x)));
+	}
+	std::sort(ids.begin(), ids.end());
+	ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+	MonomialMap m;
+	for (MonomialID id: ids) m.storeMonomial(id);
+	ASSERT_EQ(m.size(), int(ids.size()));
+	for (size_t i = 0; i < ids.size(); i += 3) m.erase(ids[i]);
+	for (size_t i = 0; i < ids.size(); ++i){
+		ASSERT_EQ(m.containsMonomial(ids[i]), i % 3 != 0);
+	}
+	//выбор с удалением обходит все оставшиеся мономы
+	MonomialMap queue;
+	for (MonomialID id: ids) queue.storeMonomial(id);
+	size_t selected = 0;
+	while (!queue.empty()){
+		queue.erase(queue.selectMonomialID());
+		++selected;
+	}
+	EXPECT_EQ(selected, ids.size());
+	//после перенумерации числа убывают вместе с мономами
+	MonomialMap columns;
+	for (MonomialID id: ids) columns.storeMonomial(id);
+	columns.UpdateForUsingReversed();
+	for (int i = 0; i < columns.size(); ++i){
+		ASSERT_EQ(columns.getMonomialID(columns.getMonomialRevID(i)), i);
+		if (i) { ASSERT_GT(columns.getMonomialRev(i - 1).compareTo(columns.getMonomialRev(i)), 0); }
+	}
+	//очищенное множество используется повторно, как на следующем шаге F4
+	columns.clear();
+	EXPECT_TRUE(columns.empty());
+	for (size_t i = 0; i < ids.size(); i += 2) columns.storeMonomial(ids[i]);
+	columns.UpdateForUsingReversed();
+	ASSERT_EQ(columns.size(), int((ids.size() + 1) / 2));
+	for (size_t i = 0; i < ids.size(); ++i){
+		ASSERT_EQ(columns.containsMonomial(ids[i]), i % 2 == 0);
+	}
+	for (int i = 0; i < columns.size(); ++i){
+		ASSERT_EQ(columns.getMonomialID(columns.getMonomialRevID(i)), i);
+		if (i) { ASSERT_GT(columns.getMonomialRev(i - 1).compareTo(columns.getMonomialRev(i)), 0); }
+	}
+	globalF4MPI::Finalize();
+}
+
+//соответствие мономов столбцам, построенное в множестве от предыдущей матрицы, совпадает с построенным в новом множестве
+TEST(MonomialMap, matrixMonomialsAfterReuse)
+{
+	uint64_t x = 88172645463325252ull;
+	InitMonomials(6);
+	std::vector<CPolynomial> polys(3000);
+	for (auto& p: polys) p.pushTermBack(CModular(1), RandomMonomial(6, x));
+	//у соседних матриц общая половина мономов
+	const std::vector<CPolynomial> previous(polys.begin(), polys.begin() + 2000), next(polys.begin() + 1000, polys.end());
+	MonomialMap reused, fresh;
+	storeMatrixMonomials(previous, reused);
+	storeMatrixMonomials(next, reused);
+	storeMatrixMonomials(next, fresh);
+	ASSERT_EQ(reused.size(), fresh.size());
+	for (int i = 0; i < fresh.size(); ++i){
+		ASSERT_EQ(reused.getMonomialRevID(i), fresh.getMonomialRevID(i));
+		ASSERT_EQ(reused.getMonomialID(fresh.getMonomialRevID(i)), i);
+	}
+	globalF4MPI::Finalize();
+}
+
+//поразрядная сортировка столбцов, в том числе по потокам и с неполными ключами, упорядочивает мономы так же, как сравнение
+TEST(MonomialMap, columnOrderMatchesComparison)
+{
+	uint64_t x = 88172645463325252ull;
+	ThreadPool pool(4);
+	for (int variables: {5, 20})
+	for (auto order: {CMonomialBase::lexOrder, CMonomialBase::degrevlexOrder, CMonomialBase::blklexOrder}){
+		InitMonomials(variables, 1, order, variables / 2);
+		std::vector<MonomialID> ids;
+		for (int i = 0; i < 40000; ++i) ids.push_back(globalF4MPI::InternedMonomials.intern(RandomMonomial(variables, x)));
+		for (ThreadPool* p: {(ThreadPool*)0, &pool}){
+			MonomialMap columns;
+			for (MonomialID id: ids) columns.storeMonomial(id);
+			const int n = columns.size();
+			columns.UpdateForUsingReversed(p);
+			ASSERT_EQ(columns.size(), n);
+			for (int i = 0; i < n; ++i){
+				ASSERT_EQ(columns.getMonomialID(columns.getMonomialRevID(i)), i);
+				if (i) { ASSERT_GT(columns.getMonomialRev(i - 1).compareTo(columns.getMonomialRev(i)), 0) << "order " << order; }
+			}
+		}
+	}
+	globalF4MPI::Finalize();
+}
@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+#include "densematrix.h"
+#include "cmodular.h"
+#include <vector>
+#include <cstdint>
+using namespace F4MPI;
+
+namespace{
+typedef std::vector<std::vector<uint32_t>> Rows;
+
+//простой метод Гаусса-Жордана: ненулевые строки сильно ступенчатого вида по возрастанию ведущего столбца
+Rows referenceReducedForm(Rows a, uint32_t p)
+{
+	Rows result;
+	const int columns = a.empty() ? 0 : a[0].size();
+	for (int c = 0; c < columns; ++c){
+		int r = 0;
+		while (r < int(a.size()) && a[r][c] == 0) ++r;
+		if (r == int(a.size())) continue;
+		std::vector<uint32_t> pivot = a[r];
+		a.erase(a.begin() + r);
+		const uint64_t inv = CModular::inverseMod(CModular(pivot[c])).toint();
+		for (auto& v: pivot) v = uint32_t(v * inv % p);
+		for (auto* rows: {&a, &result}){
+			for (auto& row: *rows){
+				const uint64_t k = row[c];
+				for (int j = 0; j < columns; ++j) row[j] = uint32_t((row[j] + (p - k) * pivot[j]) % p);
+			}
+		}
+		result.push_back(pivot);
+	}
+	return result;
+}
+}
+
+TEST(DenseMatrix, reducedFormMatchesReference)
+{
+	const uint32_t moduli[] = {2, 31013, 65537, 2147483647u};
+	uint64_t x = 88172645463325252ull;
+	ThreadPool pool(3);
+	for (uint32_t p: moduli){
+		CModular::setMOD(p);
+		for (int size: {1, 5, 40}){
+			const int rows = size + 3, columns = 2 * size + 1;
+			Rows a(rows, std::vector<uint32_t>(columns));
+			for (int i = 0; i < rows; ++i){
+				for (int j = 0; j < columns; ++j){
+					x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+					//разреженные и линейно зависимые строки дают нулевые строки и пропуски столбцов
+					a[i][j] = (x >> 40) % 3 ? 0 : uint32_t((x >> 8) % p);
+				}
+				if (i % 4 == 3) a[i] = a[i - 1];
+			}
+			const Rows expected = referenceReducedForm(a, p);
+			for (ThreadPool* usedPool: {(ThreadPool*)0, &pool}){
+				DenseMatrix m(rows, columns);
+				for (int i = 0; i < rows; ++i) std::copy(a[i].begin(), a[i].end(), m.row(i));
+				const int rank = m.rowEchelonForm(true, usedPool);
+				ASSERT_EQ(rank, int(expected.size())) << "mod " << p << " size " << size;
+				for (const auto& row: expected){
+					int found = -1;
+					for (int i = 0; i < rank; ++i){
+						if (std::equal(row.begin(), row.end(), m.row(i))) found = i;
+					}
+					EXPECT_GE(found, 0) << "mod " << p << " size " << size;
+				}
+				for (int i = rank; i < rows; ++i){
+					for (int j = 0; j < columns; ++j) EXPECT_EQ(m.row(i)[j], 0u);
+				}
+			}
+		}
+	}
+}
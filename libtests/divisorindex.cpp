@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+#include "divisorindex.h"
+#include "globalf4.h"
+#include <algorithm>
+#include <vector>
+#include <cstdint>
+using namespace F4MPI;
+
+namespace{
+void InitMonomials(int variables, int degreeBytes = 1, int sparseTerms = 0)
+{
+	globalF4MPI::globalOptions.degreeBytes = degreeBytes;
+	globalF4MPI::globalOptions.sparseTerms = sparseTerms;
+	globalF4MPI::globalOptions.numberOfVariables = variables;
+	globalF4MPI::globalOptions.mod = 31013;
+	globalF4MPI::globalOptions.monomOrder = CMonomialBase::degrevlexOrder;
+	globalF4MPI::globalOptions.monomOrderParam = 0;
+	globalF4MPI::InitializeGlobalOptions();
+}
+
+//в основном малые степени, иногда превышающие число битов маски на переменную
+CMonomial RandomMonomial(int variables, uint64_t& x)
+{
+	std::vector<CMonomialBase::Deg> degrees(variables);
+	int total;
+	do{
+		total = 0;
+		for (auto& d: degrees){
+			x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+			d = (x >> 20) % 4 ? (x >> 30) % 2 : (x >> 40) % 6;
+			total += d;
+		}
+	}while (total > CMonomialBase::maxDegree);
+	return CMonomial(degrees);
+}
+
+//не более 4 переменных с ненулевой степенью
+CMonomial RandomSparseMonomial(int variables, uint64_t& x)
+{
+	std::vector<CMonomialBase::Deg> degrees(variables);
+	for (int k = 0; k < 4; ++k){
+		x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+		degrees[(x >> 20) % variables] += (x >> 40) % 3;
+	}
+	return CMonomial(degrees);
+}
+
+bool DivisibleByDegrees(const CMonomial& a, const CMonomial& b, int variables)
+{
+	for (int i = 0; i < variables; ++i){
+		if (a.getDegree(i) < b.getDegree(i)) return false;
+	}
+	return true;
+}
+}
+
+//индекс делимости находит те же делители и кратные, что и перебор, в том числе после удалений и для разреженных мономов
+TEST(DivisorIndex, matchesExhaustiveSearch)
+{
+	uint64_t x = 88172645463325252ull;
+	for (int variables: {3, 12, 40, 150}){
+		if (variables == 150){
+			InitMonomials(variables, 2, 16);
+		}else{
+			InitMonomials(variables);
+		}
+		MonomialTable& table = globalF4MPI::InternedMonomials;
+		std::vector<CMonomial> monomials;
+		DivisorIndex index;
+		std::vector<bool> present;
+		for (int i = 0; i < 400; ++i){
+			monomials.push_back(variables == 150 ? RandomSparseMonomial(variables, x) : RandomMonomial(variables, x));
+			index.insert(table.intern(monomials.back()), i);
+			present.push_back(true);
+		}
+		for (int round = 0; round < 2; ++round){
+			for (const auto& m: monomials){
+				int expected = -1;
+				for (int i = 0; i < int(monomials.size()); ++i){
+					if (present[i] && expected < 0 && DivisibleByDegrees(m, monomials[i], variables)) expected = i;
+				}
+				ASSERT_EQ(index.minimalDivisor(m), expected) << m.toString();
+				ASSERT_EQ(index.hasDivisor(m), expected >= 0);
+			}
+			//удаляются кратные нескольких мономов
+			for (int k = 0; k < 30; k += 3){
+				std::vector<int> removed, expected;
+				for (int i = 0; i < int(monomials.size()); ++i){
+					if (present[i] && DivisibleByDegrees(monomials[i], monomials[k], variables)) expected.push_back(i);
+				}
+				index.removeMultiples(monomials[k], removed);
+				std::sort(removed.begin(), removed.end());
+				ASSERT_EQ(removed, expected) << monomials[k].toString();
+				for (int i: removed) present[i] = false;
+			}
+			EXPECT_EQ(index.size(), size_t(std::count(present.begin(), present.end(), true)));
+		}
+		//после удаления всех элементов опустевшие листья сливаются, и индекс заполняется заново
+		std::vector<int> removed;
+		index.removeMultiples(CMonomial(), removed);
+		EXPECT_EQ(index.size(), 0u);
+		EXPECT_EQ(index.minimalDivisor(monomials[0]), -1);
+		for (int i = int(monomials.size()) - 1; i >= 0; --i) index.insert(table.intern(monomials[i]), i);
+		for (const auto& m: monomials){
+			int expected = -1;
+			for (int i = 0; i < int(monomials.size()) && expected < 0; ++i){
+				if (DivisibleByDegrees(m, monomials[i], variables)) expected = i;
+			}
+			ASSERT_EQ(index.minimalDivisor(m), expected) << m.toString();
+		}
+	}
+	InitMonomials(2);
+	globalF4MPI::Finalize();
+}
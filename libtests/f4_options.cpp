@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+#include <string>
+#include "libf4mpi.h"
+
+namespace{
+const char* const kCyclic5Header = "w x5 x4 x3 x2 x1\ndegrevlex\n";
+const char* const kCyclic5Polys =
+	"x1+x2+x3+x4+x5,\n"
+	"x1*x2+x1*x5+x2*x3+x3*x4+x4*x5,\n"
+	"x1*x2*x3+x1*x2*x5+x1*x4*x5+x2*x3*x4+x3*x4*x5,\n"
+	"x1*x2*x3*x4+x1*x2*x3*x5+x1*x2*x4*x5+x1*x3*x4*x5+x2*x3*x4*x5,\n"
+	"-w^5+x1*x2*x3*x4*x5\n";
+const char* const kKatsura6 =
+	"t u6 u5 u4 u3 u2 u1 u0\ndegrevlex\n31013\n"
+	"u0^2-t*u0+2*u1^2+2*u2^2+2*u3^2+2*u4^2+2*u5^2+2*u6^2,\n"
+	"2*u0*u1+2*u1*u2-u1*t+2*u2*u3+2*u3*u4+2*u4*u5+2*u5*u6,\n"
+	"2*u0*u2+u1^2+2*u1*u3+2*u2*u4-u2*t+2*u3*u5+2*u4*u6,\n"
+	"2*u0*u3+2*u1*u2+2*u1*u4+2*u2*u5+2*u3*u6-u3*t,\n"
+	"2*u0*u4+2*u1*u3+2*u1*u5+u2^2+2*u2*u6-u4*t,\n"
+	"2*u0*u5+2*u1*u4+2*u1*u6+2*u2*u3-u5*t,\n"
+	"u0+2*u1+2*u2+2*u3+2*u4+2*u5+2*u6-t\n";
+
+std::string Cyclic5(const char* mod)
+{
+	return std::string(kCyclic5Header) + mod + "\n" + kCyclic5Polys;
+}
+
+typedef void (*OptionsAdjuster)(F4AlgOptions& options);
+
+std::string RunF4(const std::string& input, OptionsAdjuster adjust)
+{
+	int argc = 0;
+	char** argv = nullptr;
+	MPIStartInfo mpi_info(argc, argv);
+	F4AlgOptions options;
+	initDefaultF4Options(&options);
+	if (adjust) adjust(options);
+	std::string output;
+	EXPECT_EQ(LIBF4_NO_ERROR, runF4MPIFromString(input, output, &options, mpi_info));
+	return output;
+}
+
+//any combination of options must lead to the same reduced basis as the default one
+void ExpectSameBasis(OptionsAdjuster adjust)
+{
+	//65521 is the largest prime with 16-bit residues, 65537 the smallest one above it
+	const std::string inputs[] = {Cyclic5("31013"), Cyclic5("2"), Cyclic5("3"), Cyclic5("65521"), Cyclic5("65537"), kKatsura6};
+	for (const auto& input: inputs)
+	{
+		std::string expected = RunF4(input, nullptr);
+		EXPECT_NE(expected.find(','), std::string::npos);
+		EXPECT_EQ(expected, RunF4(input, adjust)) << input;
+	}
+}
+}
+
+TEST(F4Options, RowEchelonEachStep)
+{
+	ExpectSameBasis([](F4AlgOptions& o){o.diagonalEachStep = 0;});
+}
+
+TEST(F4Options, BlockReduction)
+{
+	ExpectSameBasis([](F4AlgOptions& o){o.innerGaussBlockSize = 16; o.MPIBlockSize = 7;});
+}
+
+TEST(F4Options, ABCDDecomposition)
+{
+	ExpectSameBasis([](F4AlgOptions& o){o.useABCDDecomposition = 1;});
+	ExpectSameBasis([](F4AlgOptions& o){o.useABCDDecomposition = 1; o.diagonalEachStep = 0;});
+}
+
+TEST(F4Options, DenseAccumulator)
+{
+	ExpectSameBasis([](F4AlgOptions& o){o.useDenseAccumulator = 1;});
+	ExpectSameBasis([](F4AlgOptions& o){o.useDenseAccumulator = 1; o.diagonalEachStep = 0;});
+	ExpectSameBasis([](F4AlgOptions& o){o.useDenseAccumulator = 1; o.useABCDDecomposition = 1;});
+}
+
+TEST(F4Options, Threads)
+{
+	ExpectSameBasis([](F4AlgOptions& o){o.numberOfThreads = 4;});
+	ExpectSameBasis([](F4AlgOptions& o){o.numberOfThreads = 3; o.innerGaussBlockSize = 4; o.diagonalEachStep = 0;});
+	ExpectSameBasis([](F4AlgOptions& o){o.numberOfThreads = 4; o.useDenseAccumulator = 1; o.useABCDDecomposition = 1;});
+}
+
+TEST(F4Options, DenseBlockElimination)
+{
+	//1% makes almost every block D dense, 0 disables dense elimination
+	ExpectSameBasis([](F4AlgOptions& o){o.useABCDDecomposition = 1; o.denseBlockFilling = 1;});
+	ExpectSameBasis([](F4AlgOptions& o){o.useABCDDecomposition = 1; o.denseBlockFilling = 1; o.diagonalEachStep = 0;});
+	ExpectSameBasis([](F4AlgOptions& o){o.useABCDDecomposition = 1; o.denseBlockFilling = 1; o.numberOfThreads = 3;});
+	ExpectSameBasis([](F4AlgOptions& o){o.useABCDDecomposition = 1; o.denseBlockFilling = 0;});
+}
+
+TEST(F4Options, GF2Engine)
+{
+	//for modulus 2 the default options use the bit-packed engine, the sparse one must give the same basis
+	ExpectSameBasis([](F4AlgOptions& o){o.useGF2Engine = 0;});
+	ExpectSameBasis([](F4AlgOptions& o){o.useGF2Engine = 0; o.diagonalEachStep = 0;});
+	ExpectSameBasis([](F4AlgOptions& o){o.useGF2Engine = 0; o.useABCDDecomposition = 1;});
+	ExpectSameBasis([](F4AlgOptions& o){o.diagonalEachStep = 0; o.numberOfThreads = 3;});
+}
+
+TEST(F4Options, WideDegrees)
+{
+	//input degree above the 8-bit bound: the wider representation is chosen while parsing
+	EXPECT_EQ("y^3+31012,\nx^120+31012*y\n", RunF4("y x\ndegrevlex\n31013\nx^120-y,\ny^3-1\n", nullptr));
+	//degrees overflow 8 bits only during the computation, which is restarted with 16-bit degrees
+	const std::string basis = RunF4("z y x\ndegrevlex\n31013\nx^40*y-z,\ny^40*z-x,\nz^40*x-y\n", nullptr);
+	EXPECT_NE(basis.find("z^81+31012*x^38*y^3"), std::string::npos) << basis;
+	//the overflow may happen in worker threads of the symbolic preprocessing
+	EXPECT_EQ(basis, RunF4("z y x\ndegrevlex\n31013\nx^40*y-z,\ny^40*z-x,\nz^40*x-y\n", [](F4AlgOptions& o){o.numberOfThreads = 4;}));
+}
+
+TEST(F4Options, SparseMonomials)
+{
+	//variables absent from the polynomials do not change the basis, but make sparse monomials preferable
+	std::string header = "w x5 x4 x3 x2 x1";
+	for (int i = 1; i <= 200; ++i) header += " y" + std::to_string(i);
+	const std::string input = header + "\ndegrevlex\n31013\n" + kCyclic5Polys;
+	EXPECT_EQ(RunF4(Cyclic5("31013"), nullptr), RunF4(input, nullptr));
+}
+
+TEST(F4Options, SPairSelection)
+{
+	ExpectSameBasis([](F4AlgOptions& o){o.sPairSelection = 1;});
+	//sugar differs from the LCM degree only for inhomogeneous systems
+	const std::string affine = std::string("x5 x4 x3 x2 x1\ndegrevlex\n31013\n") +
+		"x1+x2+x3+x4+x5,\nx1*x2+x1*x5+x2*x3+x3*x4+x4*x5,\nx1*x2*x3+x1*x2*x5+x1*x4*x5+x2*x3*x4+x3*x4*x5,\n"
+		"x1*x2*x3*x4+x1*x2*x3*x5+x1*x2*x4*x5+x1*x3*x4*x5+x2*x3*x4*x5,\nx1*x2*x3*x4*x5-1\n";
+	EXPECT_EQ(RunF4(affine, nullptr), RunF4(affine, [](F4AlgOptions& o){o.sPairSelection = 1;}));
+}
+
+TEST(F4Options, SPairDegreeCap)
+{
+	//the cap above the degrees of all pairs changes nothing, a low one truncates the basis
+	ExpectSameBasis([](F4AlgOptions& o){o.sPairDegreeCap = 100;});
+	ExpectSameBasis([](F4AlgOptions& o){o.sPairDegreeCap = 100; o.sPairSelection = 1;});
+	const std::string input = Cyclic5("31013");
+	EXPECT_NE(RunF4(input, nullptr), RunF4(input, [](F4AlgOptions& o){o.sPairDegreeCap = 4;}));
+}
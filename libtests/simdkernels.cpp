@@ -0,0 +1,162 @@
+#include <gtest/gtest.h>
+#include "simdkernels.h"
+#include "rowaccumulator.h"
+#include <vector>
+#include <cstdint>
+using namespace F4MPI;
+using namespace F4MPI::SIMD;
+
+namespace{
+uint32_t nextRandom(uint64_t& x){
+	x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+	return uint32_t(x >> 16);
+}
+
+//все уровни, доступные на данном процессоре
+std::vector<Level> availableLevels(){
+	std::vector<Level> levels;
+	for (int l = LEVEL_SCALAR; l <= detectedLevel(); ++l) levels.push_back(Level(l));
+	return levels;
+}
+
+//разреженная строка с ненулевыми элементами плотного вектора \a dense
+CRow sparseRow(const std::vector<uint32_t>& dense){
+	std::vector<RowElement> elements;
+	for (int j = 0; j < int(dense.size()); ++j){
+		if (!dense[j]) continue;
+		RowElement e;
+		e.column = j;
+		e.value = CModular(int(dense[j]));
+		elements.push_back(e);
+	}
+	CRow row;
+	row.resize(elements.size());
+	std::copy(elements.begin(), elements.end(), row.begin());
+	return row;
+}
+}
+
+//векторные варианты каждого ядра должны давать тот же результат, что и скалярный
+TEST(SIMD, kernelsMatchScalar)
+{
+	const uint32_t moduli[] = {2, 3, 31013, 65521, 65536, 65537, 2147483647u};
+	const Level savedLevel = activeLevel();
+	uint64_t x = 88172645463325252ull;
+	for (uint32_t p: moduli){
+		for (int n: {0, 1, 7, 8, 9, 16, 33, 100}){
+			std::vector<int32_t> values(n), pairs(2 * n);
+			std::vector<int> columns(n);
+			std::vector<uint16_t> values16(n);
+			for (int i = 0; i < n; ++i){
+				values[i] = nextRandom(x) % p;
+				pairs[2 * i] = 3 * i + nextRandom(x) % 3;
+				pairs[2 * i + 1] = nextRandom(x) % p;
+				columns[i] = pairs[2 * i];
+				values16[i] = uint16_t(values[i]);
+			}
+			const uint32_t c = nextRandom(x) % p;
+			const int width = 3 * n + 1;
+			std::vector<uint64_t> refAcc16, refAcc32, refAccPairs, refDense;
+			std::vector<int32_t> refValues, refPairs;
+			for (Level level: availableLevels()){
+				setMaxLevel(level);
+				std::vector<int32_t> v(values), pr(pairs);
+				mulModContiguous(v.data(), n, c, p);
+				mulModPairs(pr.data(), n, c, p);
+				std::vector<uint64_t> acc16(width, 5), acc32(width, 5), accPairs(width, 5);
+				scatterAddScaled(acc16.data(), columns.data(), values16.data(), n, c);
+				scatterAddScaled(acc32.data(), columns.data(), values.data(), n, c);
+				scatterAddScaledPairs(accPairs.data(), pairs.data(), n, c);
+				std::vector<uint64_t> dense(n, 7);
+				addScaledDense(dense.data(), reinterpret_cast<const uint32_t*>(values.data()), n, c);
+				if (level == LEVEL_SCALAR){
+					for (int i = 0; i < n; ++i){
+						ASSERT_EQ(uint32_t(v[i]), uint64_t(values[i]) * c % p);
+						ASSERT_EQ(pr[2 * i], pairs[2 * i]);
+						ASSERT_EQ(uint32_t(pr[2 * i + 1]), uint64_t(pairs[2 * i + 1]) * c % p);
+						ASSERT_EQ(dense[i], 7 + uint64_t(values[i]) * c);
+						ASSERT_EQ(accPairs[pairs[2 * i]], 5 + uint64_t(pairs[2 * i + 1]) * c);
+					}
+					refValues = v; refPairs = pr; refAcc16 = acc16; refAcc32 = acc32; refAccPairs = accPairs; refDense = dense;
+				}else{
+					EXPECT_EQ(v, refValues) << "level " << level << " mod " << p << " n " << n;
+					EXPECT_EQ(pr, refPairs) << "level " << level << " mod " << p << " n " << n;
+					EXPECT_EQ(acc16, refAcc16) << "level " << level << " n " << n;
+					EXPECT_EQ(acc32, refAcc32) << "level " << level << " n " << n;
+					EXPECT_EQ(accPairs, refAccPairs) << "level " << level << " n " << n;
+					EXPECT_EQ(dense, refDense) << "level " << level << " n " << n;
+				}
+			}
+		}
+	}
+	setMaxLevel(savedLevel);
+}
+
+TEST(SIMD, findNonZero)
+{
+	const Level savedLevel = activeLevel();
+	for (Level level: availableLevels()){
+		setMaxLevel(level);
+		std::vector<uint64_t> a(70, 0);
+		EXPECT_EQ(findNonZero(a.data(), 0, 70), 70);
+		EXPECT_EQ(findNonZero(a.data(), 5, 5), 5);
+		for (int pos: {0, 3, 8, 17, 63, 69}){
+			a[pos] = uint64_t(1) << 40;
+			for (int from = 0; from <= pos; ++from){
+				ASSERT_EQ(findNonZero(a.data(), from, 70), pos) << "level " << level << " from " << from;
+			}
+			EXPECT_EQ(findNonZero(a.data(), 0, pos), pos);
+			EXPECT_EQ(findNonZero(a.data(), pos + 1, 70), 70);
+			a[pos] = 0;
+		}
+	}
+	setMaxLevel(savedLevel);
+}
+
+//операции над строками, использующие векторные ядра, должны давать одинаковый результат на всех уровнях
+TEST(SIMD, rowOperationsMatchReference)
+{
+	const uint32_t moduli[] = {2, 31013, 65537, 2147483647u};
+	const Level savedLevel = activeLevel();
+	const int savedMod = CModular::getMOD();
+	uint64_t x = 88172645463325252ull;
+	for (uint32_t p: moduli){
+		CModular::setMOD(p);
+		for (int n: {0, 5, 16, 40, 100}){
+			const int width = 3 * n + 1;
+			//разреженные строки с частично совпадающими столбцами
+			std::vector<uint32_t> a(width), b(width);
+			for (int j = 0; j < width; ++j){
+				if (nextRandom(x) % 3 == 0) a[j] = 1 + nextRandom(x) % (p - 1);
+				if (nextRandom(x) % 3 == 0) b[j] = 1 + nextRandom(x) % (p - 1);
+			}
+			const CRow rowA = sparseRow(a), rowB = sparseRow(b);
+			CSRMatrix csrB;
+			csrB.appendRow(rowB);
+			for (uint32_t c: {1u, nextRandom(x) % (p - 1) + 1}){
+				std::vector<std::pair<int, uint32_t> > expected;
+				for (int j = 0; j < width; ++j){
+					const uint32_t v = uint32_t((a[j] + uint64_t(c) * b[j]) % p);
+					if (v) expected.push_back(std::make_pair(j, v));
+				}
+				for (Level level: availableLevels()){
+					setMaxLevel(level);
+					CRow byRow = rowA, byCSR = rowA, accumulated;
+					byRow.addRowMultypliedBy(rowB, CModular(int(c)));
+					if (!rowB.empty()) byCSR.addRowMultypliedBy(csrB[0], CModular(int(c)));
+					DenseRowAccumulator<BarrettModulus> acc(BarrettModulus(p), width);
+					acc.load(rowA);
+					acc.addMultiplied(rowB, CModular(int(c)));
+					acc.store(accumulated);
+					for (const CRow* r: {&byRow, &byCSR, &accumulated}){
+						std::vector<std::pair<int, uint32_t> > got;
+						for (const RowElement& e: *r) got.push_back(std::make_pair(e.column, uint32_t(e.value.toint())));
+						EXPECT_EQ(got, expected) << "level " << level << " mod " << p << " n " << n << " c " << c;
+					}
+				}
+			}
+		}
+	}
+	CModular::setMOD(savedMod);
+	setMaxLevel(savedLevel);
+}
@@ -0,0 +1,283 @@
+#include <gtest/gtest.h>
+#include "spairs.h"
+#include "globalf4.h"
+#include "commonpolyops.h"
+#include <algorithm>
+#include <vector>
+using namespace F4MPI;
+
+namespace{
+//переменные x, y, z, w имеют номера 0..3
+class SPairSetTest: public ::testing::Test{
+protected:
+	void SetUp() override
+	{
+		globalF4MPI::globalOptions.degreeBytes = 1;
+		globalF4MPI::globalOptions.sparseTerms = 0;
+		globalF4MPI::globalOptions.numberOfVariables = 4;
+		globalF4MPI::globalOptions.mod = 31013;
+		globalF4MPI::globalOptions.monomOrder = CMonomialBase::degrevlexOrder;
+		globalF4MPI::globalOptions.monomOrderParam = 0;
+		globalF4MPI::InitializeGlobalOptions();
+	}
+
+	void TearDown() override
+	{
+		globalF4MPI::Finalize();
+	}
+
+	static CMonomial Mon(int x, int y, int z, int w)
+	{
+		return CMonomial(std::vector<CMonomialBase::Deg>{CMonomialBase::Deg(x), CMonomialBase::Deg(y), CMonomialBase::Deg(z), CMonomialBase::Deg(w)});
+	}
+
+	//для множества пар важны только старшие мономы
+	static CPolynomial Poly(const CMonomial& head)
+	{
+		CPolynomial p;
+		p.pushTermBack(CModular(1), head);
+		return p;
+	}
+
+	//добавляет многочлен с заданным старшим мономом и возвращает его номер в множестве пар
+	int Add(const CMonomial& head)
+	{
+		const CPolynomial p = Poly(head);
+		return Add(p, SPairSet::sugarOf(p));
+	}
+
+	//добавляет многочлен с заданным сахаром и возвращает его номер в множестве пар
+	int Add(const CPolynomial& p, int sugar)
+	{
+		sPairs.update(G, p, sugar);
+		return added++;
+	}
+
+	//пары (first, second) в порядке возрастания
+	std::vector<std::pair<int, int> > Pairs()const
+	{
+		std::vector<std::pair<int, int> > result;
+		for (const auto& p: sPairs.pairs()) result.push_back(std::make_pair(std::min(p.first, p.second), std::max(p.first, p.second)));
+		std::sort(result.begin(), result.end());
+		return result;
+	}
+
+	SPairSet sPairs;
+	PolynomSet G;
+	int added = 0;
+};
+
+typedef std::vector<std::pair<int, int> > PairList;
+}
+
+TEST_F(SPairSetTest, chainCriterionRemovesOldPair)
+{
+	const int g1 = Add(Mon(2, 1, 0, 0));
+	const int g2 = Add(Mon(0, 1, 2, 0));
+	EXPECT_EQ(Pairs(), PairList({{g1, g2}}));
+	//x*y*z делит НОК(g1, g2) = x^2*y*z^2, а его НОК с g1 и g2 - собственные делители этого НОК
+	const int h = Add(Mon(1, 1, 1, 0));
+	EXPECT_EQ(Pairs(), PairList({{g1, h}, {g2, h}}));
+	EXPECT_EQ(G.size(), 3u);
+}
+
+TEST_F(SPairSetTest, equalLcmsGiveOnePair)
+{
+	const int g1 = Add(Mon(1, 0, 1, 0));
+	const int g2 = Add(Mon(0, 1, 1, 0));
+	//НОК x*y и с x*z, и с y*z равны x*y*z; старая пара с тем же НОК остаётся
+	const int h = Add(Mon(1, 1, 0, 0));
+	const PairList pairs = Pairs();
+	ASSERT_EQ(pairs.size(), 2u);
+	EXPECT_EQ(pairs[0], std::make_pair(g1, g2));
+	EXPECT_EQ(pairs[1].second, h);
+	EXPECT_EQ(sPairs.size(), 2u);
+}
+
+TEST_F(SPairSetTest, coprimeGroupIsDropped)
+{
+	Add(Mon(0, 0, 2, 0));
+	const int g2 = Add(Mon(1, 0, 0, 1));
+	EXPECT_TRUE(sPairs.empty());
+	//x*y взаимно прост с z^2: пары с ним нет, а пара с x*w остаётся
+	const int h = Add(Mon(1, 1, 0, 0));
+	EXPECT_EQ(Pairs(), PairList({{g2, h}}));
+}
+
+TEST_F(SPairSetTest, multiplesOfNewHeadLeaveBasis)
+{
+	const int g1 = Add(Mon(2, 1, 0, 0));
+	Add(Mon(0, 0, 1, 0));
+	ASSERT_EQ(G.size(), 2u);
+	//x^2*y кратен x*y и покидает базис; их пара остаётся, чтобы редуцировать его
+	const int g = Add(Mon(1, 1, 0, 0));
+	EXPECT_EQ(Pairs(), PairList({{g1, g}}));
+	ASSERT_EQ(G.size(), 2u);
+	EXPECT_TRUE(G[0].HM() == Mon(0, 0, 1, 0) || G[1].HM() == Mon(0, 0, 1, 0));
+	EXPECT_TRUE(G[0].HM() == Mon(1, 1, 0, 0) || G[1].HM() == Mon(1, 1, 0, 0));
+	//удалённый элемент не участвует в парах следующих многочленов
+	const int h = Add(Mon(0, 1, 0, 1));
+	EXPECT_EQ(Pairs(), PairList({{g1, g}, {g, h}}));
+}
+
+//сахар исходного многочлена - наибольшая полная степень его членов
+TEST_F(SPairSetTest, sugarOfPolynomial)
+{
+	CPolynomial p;
+	p.pushTermBack(CModular(1), Mon(1, 2, 0, 0));
+	p.pushTermBack(CModular(3), Mon(0, 0, 1, 0));
+	EXPECT_EQ(SPairSet::sugarOf(p), 3);
+	EXPECT_EQ(SPairSet::sugarOf(Poly(Mon(0, 0, 0, 0))), 0);
+}
+
+//сахар пары - наибольший из сахаров многочленов, домноженных до НОК; стратегии выбирают пары по степени НОК или по сахару
+TEST_F(SPairSetTest, pairSugarAndSelection)
+{
+	for (auto strategy: {SPairSet::normalStrategy, SPairSet::sugarStrategy}){
+		sPairs = SPairSet(strategy);
+		G.clear();
+		added = 0;
+		const int g1 = Add(Poly(Mon(2, 0, 0, 0)), 5);
+		const int g2 = Add(Poly(Mon(1, 1, 0, 0)), 2);
+		//НОК(x^2, y^2*z^2) взаимно прост: остаются пары (g1, g2) со степенью 3 и сахаром 6 и (g2, g3) со степенью 5 и сахаром 5
+		const int g3 = Add(Poly(Mon(0, 2, 2, 0)), 4);
+		ASSERT_EQ(sPairs.size(), 2u);
+		//пара извлекается двумя строками: многочлены пары, домноженные до НОК
+		std::vector<SPairSet::Row> rows;
+		const int sugar = sPairs.takeMinimal(rows);
+		ASSERT_EQ(rows.size(), 2u);
+		std::vector<int> polys{rows[0].poly, rows[1].poly};
+		std::sort(polys.begin(), polys.end());
+		if (strategy == SPairSet::normalStrategy){
+			EXPECT_EQ(polys, std::vector<int>({g1, g2}));
+			EXPECT_EQ(sugar, 6);
+		}else{
+			EXPECT_EQ(polys, std::vector<int>({g2, g3}));
+			EXPECT_EQ(sugar, 5);
+		}
+		for (const auto& r: rows){
+			const CMonomial lcm = strategy == SPairSet::normalStrategy ? Mon(2, 1, 0, 0) : Mon(1, 2, 2, 0);
+			EXPECT_TRUE(sPairs.poly(r.poly).HM() * globalF4MPI::InternedMonomials.get(r.multiplier) == lcm);
+		}
+		EXPECT_EQ(sPairs.size(), 1u);
+	}
+}
+
+//пары со степенью НОК выше ограничения не создаются
+TEST_F(SPairSetTest, degreeCapDropsPairs)
+{
+	sPairs = SPairSet(SPairSet::normalStrategy, 4);
+	const int g1 = Add(Mon(2, 0, 0, 0));
+	const int g2 = Add(Mon(1, 1, 0, 0));
+	Add(Mon(0, 2, 2, 0));
+	EXPECT_EQ(Pairs(), PairList({{g1, g2}}));
+}
+
+namespace{
+//многочлены в порядке, не зависящем от порядка их получения
+void SortPolys(PolynomSet& polys)
+{
+	std::sort(polys.begin(), polys.end(), [](const CPolynomial& a, const CPolynomial& b){return a.compareTo(b) < 0;});
+}
+
+/**\details
+Препроцессинг в исходной форме: для каждого монома строк, кроме старших мономов из \a skipped, добавляется первый редуктор,
+старший моном которого его делит, домноженный до этого монома. Результат не зависит от порядка обработки мономов.
+*/
+void EagerPreprocess(PolynomSet& polys, PolynomSet reducers, const std::vector<CMonomial>& skipped)
+{
+	std::sort(reducers.begin(), reducers.end(), [](const CPolynomial& a, const CPolynomial& b){
+		if (a.size() != b.size()) return a.size() < b.size();
+		return a.compareTo(b) < 0;
+	});
+	reducers.resize(std::unique(reducers.begin(), reducers.end()) - reducers.begin());
+	std::vector<CMonomial> done(skipped);
+	for (size_t row = 0; row < polys.size(); ++row){
+		for (int i = 0; i < int(polys[row].size()); ++i){
+			const CMonomial mon = polys[row].getMon(i);
+			if (std::find(done.begin(), done.end(), mon) != done.end()) continue;
+			done.push_back(mon);
+			for (const auto& reducer: reducers){
+				CMonomial mulby;
+				if (!mon.tryDivide(reducer.HM(), mulby)) continue;
+				CPolynomial multiplied = reducer;
+				multiplied *= mulby;
+				polys.push_back(multiplied);
+				break;
+			}
+		}
+	}
+}
+}
+
+//ленивые строки (многочлен, множитель) и препроцессинг без редукторов для старших мономов строк дают те же строки, что и построение каждой пары целиком
+TEST_F(SPairSetTest, lazyRowsMatchEagerPreprocessing)
+{
+	auto poly = [](std::initializer_list<CMonomial> mons){
+		CPolynomial p;
+		int c = 1;
+		for (const auto& m: mons) p.pushTermBack(CModular(c++), m);
+		return p;
+	};
+	//пары (g1, g2) и (g1, h) имеют общий НОК x*y*z, и g1 домножается на y в обеих
+	Add(poly({Mon(1, 0, 1, 0), Mon(0, 1, 0, 0), Mon(0, 0, 0, 1)}), 2);
+	Add(poly({Mon(0, 1, 1, 0), Mon(1, 0, 0, 0)}), 2);
+	Add(poly({Mon(1, 1, 0, 0), Mon(0, 0, 1, 0), Mon(0, 0, 0, 1)}), 2);
+	const std::vector<SPairSet::Pair> allPairs = sPairs.pairs();
+	ASSERT_EQ(allPairs.size(), 2u);
+	PolynomSet eager;
+	for (const auto& pair: allPairs){
+		ASSERT_EQ(pair.degree, allPairs.front().degree);
+		for (int i: {pair.first, pair.second}){
+			CMonomial mulby;
+			ASSERT_TRUE(globalF4MPI::InternedMonomials.get(pair.lcm).tryDivide(sPairs.poly(i).HM(), mulby));
+			CPolynomial multiplied = sPairs.poly(i);
+			multiplied *= mulby;
+			eager.push_back(multiplied);
+		}
+	}
+
+	std::vector<SPairSet::Row> rows;
+	sPairs.takeMinimal(rows);
+	EXPECT_TRUE(sPairs.empty());
+	//из четырёх произведений два совпадают и строятся один раз
+	ASSERT_EQ(rows.size(), 3u);
+	PolynomSet lazy(rows.size());
+	for (size_t i = 0; i < rows.size(); ++i) lazy[i].AssignMultiply(sPairs.poly(rows[i].poly), rows[i].multiplier);
+	SortPolys(eager);
+	eager.resize(std::unique(eager.begin(), eager.end()) - eager.begin());
+	SortPolys(lazy);
+	ASSERT_EQ(lazy, eager);
+
+	std::vector<CMonomial> heads;
+	for (const auto& p: eager) heads.push_back(p.HM());
+	PolynomSet reducers = G;
+	Preprocess(lazy, reducers);
+	PolynomSet withHeadReducers = eager;
+	EagerPreprocess(eager, G, heads);
+	EagerPreprocess(withHeadReducers, G, {});
+	SortPolys(lazy);
+	SortPolys(eager);
+	EXPECT_EQ(lazy, eager);
+	//пропуск старших мономов строк избавляет от лишних строк-редукторов
+	EXPECT_GT(withHeadReducers.size(), eager.size());
+}
+
+//повторный препроцессинг с теми же рабочими множествами мономов добавляет те же строки, в том числе для мономов добавленных строк
+TEST_F(SPairSetTest, preprocessReusesMonomialSets)
+{
+	auto poly = [](std::initializer_list<CMonomial> mons){
+		CPolynomial p;
+		int c = 1;
+		for (const auto& m: mons) p.pushTermBack(CModular(c++), m);
+		return p;
+	};
+	//строка-редуктор для y вносит моном z, для которого нужна ещё одна строка
+	PolynomSet reducers = {poly({Mon(0, 1, 0, 0), Mon(0, 0, 1, 0)}), poly({Mon(0, 0, 1, 0), Mon(0, 0, 0, 1)})};
+	PreprocessMonomials monomials;
+	for (int pass = 0; pass < 2; ++pass){
+		PolynomSet polys = {poly({Mon(1, 0, 0, 0), Mon(0, 1, 0, 0)})};
+		Preprocess(polys, reducers, 0, &monomials);
+		EXPECT_EQ(polys.size(), 3u) << "pass " << pass;
+	}
+}
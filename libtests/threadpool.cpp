@@ -0,0 +1,53 @@
+#include <gtest/gtest.h>
+#include "threadpool.h"
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <thread>
+using namespace F4MPI;
+TEST(ThreadPool, eachTaskRunsOnce)
+{
+	ThreadPool pool(4);
+	EXPECT_EQ(pool.size(), 4);
+	for (int taskCount: {0, 1, 3, 100, 1000}){
+		std::vector<std::atomic<int>> runs(taskCount);
+		for (auto& r: runs) r = 0;
+		pool.parallelFor(taskCount, [&](int i){ ++runs[i]; });
+		for (int i = 0; i < taskCount; ++i){
+			EXPECT_EQ(runs[i], 1) << "task " << i << " of " << taskCount;
+		}
+	}
+}
+
+TEST(ThreadPool, singleThread)
+{
+	ThreadPool pool(1);
+	EXPECT_EQ(pool.size(), 1);
+	int sum = 0;
+	pool.parallelFor(10, [&](int i){ sum += i; });
+	EXPECT_EQ(sum, 45);
+}
+
+TEST(ThreadPool, unevenTasksAreStolen)
+{
+	ThreadPool pool(4);
+	const int taskCount = 64;
+	std::vector<std::atomic<int>> runs(taskCount);
+	std::vector<std::thread::id> executors(taskCount);
+	for (auto& r: runs) r = 0;
+	//все тяжёлые задачи изначально попадают в диапазон вызывающего потока
+	pool.parallelFor(taskCount, [&](int i){
+		if (i < taskCount / 4) std::this_thread::sleep_for(std::chrono::milliseconds(2));
+		executors[i] = std::this_thread::get_id();
+		++runs[i];
+	});
+	for (int i = 0; i < taskCount; ++i){
+		EXPECT_EQ(runs[i], 1) << "task " << i;
+	}
+	//без перехвата все они выполнились бы вызывающим потоком
+	int stolen = 0;
+	for (int i = 0; i < taskCount / 4; ++i){
+		if (executors[i] != std::this_thread::get_id()) ++stolen;
+	}
+	EXPECT_GT(stolen, 0);
+}
@@ -50,7 +50,7 @@ template <typename T> class PODvector{
  public:
 	void operator=(const PODvector& v){
 		del();
-		if (v.empty()) first=last=0;
+		if (v.empty()) first=last=memlast=0;
 		else{
 			size_t n=v.size();
 			first=reinterpret_cast<pointer>(new aligned_buf[n]);
@@ -60,12 +60,12 @@ template <typename T> class PODvector{
 		}
 	}
 	
-	PODvector(const PODvector& v):first(0),last(0){
+	PODvector(const PODvector& v):first(0),last(0),memlast(0){
 		(*this)=v;
 	}
 	
 	PODvector():
-		first(0),last(0)
+		first(0),last(0),memlast(0)
 	{}
 
 	~PODvector(){
@@ -253,7 +253,7 @@ template <typename T> class PODvecSize{
  public:
 	void operator=(const PODvecSize& v){
 		del();
-		if (v.empty()) first=last=0;
+		if (v.empty()) first=last=memlast=0;
 		else{
 			size_t n=v.size();
 			first=new char[n*iterator_step];
@@ -264,12 +264,12 @@ template <typename T> class PODvecSize{
 		}
 	}
 	
-	PODvecSize(const PODvecSize& v):first(0),last(0){
+	PODvecSize(const PODvecSize& v):first(0),last(0),memlast(0){
 		(*this)=v;
 	}
 	
 	PODvecSize():
-		first(0),last(0)
+		first(0),last(0),memlast(0)
 	{}
 
 	~PODvecSize(){
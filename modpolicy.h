@@ -0,0 +1,118 @@
+#ifndef ModPolicy_h
+#define ModPolicy_h
+/**
+\file
+Политики арифметики по модулю для ядер редукции строк.
+Политика передаётся ядрам как параметр шаблона, и ядро работает с модулем через неё,
+а не через глобальный CModular::MOD. Для часто используемых простых модулей есть политики с модулем,
+известным при компиляции (деление на константу компилятор заменяет умножением и сдвигами),
+для остальных модулей - политика с редукцией Барретта, не использующая аппаратного деления.
+*/
+
+#include "cmodular.h"
+
+#include <cstdint>
+
+namespace F4MPI{
+/**Модуль, известный при компиляции.
+Все операции сводятся к взятию остатка от деления на константу \a P.
+*/
+template <uint32_t P>
+struct FixedModulus{
+	uint32_t value()const{
+		return P;
+	}
+
+	///остаток от деления \a x на модуль
+	uint32_t reduce(uint64_t x)const{
+		return uint32_t(x%P);
+	}
+
+	///a+b, для приведённых \a a и \a b
+	CModular add(CModular a, CModular b)const{
+		uint32_t r=uint32_t(a.toint())+uint32_t(b.toint());
+		return CModular::fromReduced(r>=P ? r-P : r);
+	}
+
+	///-a, для приведённого \a a
+	CModular neg(CModular a)const{
+		return CModular::fromReduced(a.toint() ? P-a.toint() : 0);
+	}
+
+	///a*b
+	CModular mul(CModular a, CModular b)const{
+		return CModular::fromReduced(reduce(uint64_t(a.toint())*uint64_t(b.toint())));
+	}
+
+	///a+b*c, с единственным взятием остатка
+	CModular mulAdd(CModular a, CModular b, CModular c)const{
+		return CModular::fromReduced(reduce(uint64_t(a.toint())+uint64_t(b.toint())*uint64_t(c.toint())));
+	}
+};
+
+/**Модуль, задаваемый при выполнении, с редукцией Барретта.
+Остаток от деления 64-битного числа вычисляется через старшую половину его 128-битного произведения
+на заранее вычисленное приближение 2^64/p, одно умножение и не более двух вычитаний.
+Подходит для любых модулей, помещающихся в 32 бита.
+*/
+struct BarrettModulus{
+	explicit BarrettModulus(uint32_t modulus):
+		p(modulus),
+		m(~uint64_t(0)/modulus)
+	{}
+
+	uint32_t value()const{
+		return p;
+	}
+
+	///остаток от деления \a x на модуль
+	uint32_t reduce(uint64_t x)const{
+		uint64_t q=uint64_t((unsigned __int128)x*m>>64);
+		uint64_t r=x-q*p;
+		//приближённое частное меньше точного не более чем на 2
+		if (r>=p) r-=p;
+		if (r>=p) r-=p;
+		return uint32_t(r);
+	}
+
+	CModular add(CModular a, CModular b)const{
+		uint32_t r=uint32_t(a.toint())+uint32_t(b.toint());
+		return CModular::fromReduced(r>=p ? r-p : r);
+	}
+
+	CModular neg(CModular a)const{
+		return CModular::fromReduced(a.toint() ? p-a.toint() : 0);
+	}
+
+	CModular mul(CModular a, CModular b)const{
+		return CModular::fromReduced(reduce(uint64_t(a.toint())*uint64_t(b.toint())));
+	}
+
+	CModular mulAdd(CModular a, CModular b, CModular c)const{
+		return CModular::fromReduced(reduce(uint64_t(a.toint())+uint64_t(b.toint())*uint64_t(c.toint())));
+	}
+
+  private:
+	uint32_t p;
+	///floor((2^64-1)/p)
+	uint64_t m;
+};
+
+/**Вызывает Kernel<Policy>::run(args...) с политикой, соответствующей текущему модулю CModular.
+Для модулей из списка часто используемых выбирается FixedModulus, для остальных BarrettModulus.
+Политика передаётся первым аргументом run().
+*/
+template <template <class> class Kernel, typename... Args>
+void runWithModulusPolicy(Args&&... args){
+	const int mod=CModular::getMOD();
+	switch(mod){
+		case 2: Kernel<FixedModulus<2> >::run(FixedModulus<2>(),args...); return;
+		case 3: Kernel<FixedModulus<3> >::run(FixedModulus<3>(),args...); return;
+		case 31013: Kernel<FixedModulus<31013> >::run(FixedModulus<31013>(),args...); return;
+		case 32003: Kernel<FixedModulus<32003> >::run(FixedModulus<32003>(),args...); return;
+		case 65521: Kernel<FixedModulus<65521> >::run(FixedModulus<65521>(),args...); return;
+		default: Kernel<BarrettModulus>::run(BarrettModulus(mod),args...); return;
+	}
+}
+} //namespace F4MPI
+#endif
@@ -3,20 +3,156 @@
 Реализация внешних функций работы с MonomialMap
 */
 #include "monomialmap.h"
+#include "threadpool.h"
 #include "types.h"
 
+#include <algorithm>
+
+using namespace std;
 namespace F4MPI{
 
+namespace{
+///моном вместе с его ключом порядка
+struct KeyedMonomial{
+	CMonomialBase::DegWord key;
+	MonomialID id;
+};
+
+///части не длиннее этой сортируются сравнением
+const size_t radixCutoff=64;
+///части короче этой не делятся между потоками
+const size_t minParallelPart=1<<14;
+
+///часть [from;to) сортируемого массива, в которой у всех ключей совпадают старшие digit байт
+struct RadixPart{
+	size_t from, to;
+	int digit;
+};
+
+///байт ключа \a key с номером \a digit, считая со старшего
+inline unsigned keyByte(CMonomialBase::DegWord key, int digit){
+	return unsigned(key>>(56-8*digit))&0xFF;
+}
+
+///сравнение мономов по убыванию: сначала по ключам, а при совпадении неполных ключей - по степеням
+bool greaterMonomial(const KeyedMonomial& a, const KeyedMonomial& b){
+	if (a.key!=b.key) return a.key>b.key;
+	if (CMonomialBase::orderKeyComplete) return false;
+	const MonomialTable& table=globalF4MPI::InternedMonomials;
+	return table.get(a.id).compareTo(table.get(b.id))>0;
+}
+
+/**раскладывает часть \a part по значению очередного байта ключа на месте (American flag sort),
+начиная с наибольшего значения, и дописывает непустые получившиеся части в \a parts
+*/
+void radixPartition(KeyedMonomial* data, const RadixPart& part, vector<RadixPart>& parts){
+	size_t count[256]={0};
+	for (size_t i=part.from;i<part.to;++i) ++count[keyByte(data[i].key,part.digit)];
+	size_t start[256], end[256];
+	size_t pos=part.from;
+	for (int b=255;b>=0;--b){
+		start[b]=pos;
+		pos+=count[b];
+		end[b]=pos;
+	}
+	for (int b=255;b>=0;--b){
+		if (count[b]) parts.push_back(RadixPart{end[b]-count[b],end[b],part.digit+1});
+		//start[b] - первая позиция части b, элемент на которой ещё не на своём месте
+		while (start[b]<end[b]){
+			KeyedMonomial m=data[start[b]];
+			unsigned mb=keyByte(m.key,part.digit);
+			while (int(mb)!=b){
+				swap(m,data[start[mb]++]);
+				mb=keyByte(m.key,part.digit);
+			}
+			data[start[b]++]=m;
+		}
+	}
+}
+
+///сортирует часть \a part по убыванию мономов; \a keyBytes - число значащих байтов ключа
+void radixSort(KeyedMonomial* data, const RadixPart& part, int keyBytes){
+	if (part.to-part.from<=radixCutoff || part.digit==keyBytes){
+		//после всех байтов ключа остаются только мономы с равными ключами
+		sort(data+part.from,data+part.to,greaterMonomial);
+		return;
+	}
+	vector<RadixPart> parts;
+	radixPartition(data,part,parts);
+	for (const RadixPart& p: parts) radixSort(data,p,keyBytes);
+}
+}
+
+void MonomialMap::UpdateForUsingReversed(ThreadPool* pool){
+	revM.swap(monomialStorage);
+	monomialStorage.clear();
+	selectFrom=0;
+	if (revM.empty()){
+		clear();
+		return;
+	}
+	//множество составляется заново из добавленных мономов, так что удалённые мономы в него возвращаются
+	if (used!=revM.size()){
+		const Slot empty={MonomialTable::noMonomial,0};
+		fill(slots.begin(),slots.end(),empty);
+		used=0;
+		for (MonomialID m: revM){
+			bool inserted;
+			insert(m,0,inserted);
+		}
+	}
+	if (CMonomialBase::orderKeyOrder!=CMonomialBase::getOrder()){
+		//ключи построены не для текущего порядка
+		runWithMonomialOrder<SortMonomialIDsKernel>(revM.rbegin(),revM.rend());
+		for (size_t i=0;i<revM.size();++i) slots[findSlot(revM[i])].value=int(i);
+		return;
+	}
+	const MonomialTable& table=globalF4MPI::InternedMonomials;
+	vector<KeyedMonomial> keyed(revM.size());
+	for (size_t i=0;i<revM.size();++i){
+		keyed[i].key=table.get(revM[i]).orderKey();
+		keyed[i].id=revM[i];
+	}
+	const CMonomialBase::DegWord keyMask=CMonomialBase::orderKeyMask;
+	const int keyBytes=keyMask ? 8-__builtin_ctzll(keyMask)/8 : 0;
+	//крупные части раскладываются заранее, пока не станут достаточно мелкими для распределения по потокам
+	const size_t taskSize=pool ? max(minParallelPart,keyed.size()/(8*pool->size())) : keyed.size();
+	vector<RadixPart> pending(1,RadixPart{0,keyed.size(),0}), tasks;
+	while (!pending.empty()){
+		const RadixPart part=pending.back();
+		pending.pop_back();
+		if (part.to-part.from<=taskSize || part.digit==keyBytes){
+			tasks.push_back(part);
+		}else{
+			radixPartition(&keyed[0],part,pending);
+		}
+	}
+	//каждая задача сортирует свою часть и нумерует её мономы; разные задачи изменяют разные ячейки таблицы
+	ThreadPool::Task task=[&](int t){
+		const RadixPart& part=tasks[t];
+		radixSort(&keyed[0],part,keyBytes);
+		for (size_t i=part.from;i<part.to;++i){
+			revM[i]=keyed[i].id;
+			slots[findSlot(keyed[i].id)].value=int(i);
+		}
+	};
+	if (pool && tasks.size()>1){
+		pool->parallelFor(int(tasks.size()),task);
+	}else{
+		for (size_t t=0;t<tasks.size();++t) task(int(t));
+	}
+}
+
 void storeMonomialsFromPoly(MonomialMap &M, const CPolynomial &p){
 	for(CPolynomial::m_const_iterator i = p.m_begin(); i!=p.m_end(); ++i)		
-			M.storeMonomial(*i);
+			M.storeMonomial(i.id());
 }
 
 
 
 void storeNotProcessedMonomialsFromPoly(MonomialMap &M, MonomialMap& notThere, const CPolynomial& p){
 	for(CPolynomial::m_const_iterator i = p.m_begin(); i!=p.m_end(); ++i)
-		if(!notThere.containsMonomial(*i))
-			M.storeMonomial(*i);
+		if(!notThere.containsMonomial(i.id()))
+			M.storeMonomial(i.id());
 }
 } //namespace F4MPI
@@ -7,12 +7,17 @@
 */
 
 #include "cpolynomial.h"
+#include "monomialtable.h"
 
 #include <string>
 #include <ostream>
 #include <algorithm>
 #include <unordered_map>
+#include <vector>
+#include <cstdint>
 namespace F4MPI{
+class ThreadPool;
+
 ///сравнение мономов по порядку на них
 struct monomialComparator{
 	bool operator()(const CMonomial& m1,const CMonomial& m2) const{
@@ -20,6 +25,23 @@ struct monomialComparator{
 	}
 };
 
+///сравнение мономов по порядку \a O, выбранному при компиляции
+template <CMonomialBase::Order O> struct monomialOrderComparator{
+	template <class Monomial> bool operator()(const Monomial& m1,const Monomial& m2) const{
+		return m1.template compareByOrder<O>(m2)<0;
+	}
+};
+
+///сортирует номера мономов из globalF4MPI::InternedMonomials [\a first;\a last) по возрастанию мономов в порядке \a O
+template <CMonomialBase::Order O> struct SortMonomialIDsKernel{
+	template <class Iterator> static void run(Iterator first, Iterator last){
+		const MonomialTable& table=globalF4MPI::InternedMonomials;
+		std::sort(first,last,[&table](MonomialID a, MonomialID b){
+			return monomialOrderComparator<O>()(table.get(a),table.get(b));
+		});
+	}
+};
+
 /**\details
 содержит указатель на объект, для которого operator== переопределён так,
 что сравнивает равенство указываемых объектов.*/
@@ -73,91 +95,182 @@ struct monomialHasher{
 /**множество мономов, сопоставленных целым числам.
 Класс используется как для упорядоченного соотношения между мономами и номерами столбцов матрицы,
 так и просто для хранения множества мономов не использующего соответствие с числами.
+Мономы хранятся номерами в таблице globalF4MPI::InternedMonomials, поэтому мономы многочленов
+добавляются и ищутся по их номерам без хеширования и сравнения степеней.
+Множество реализовано хеш-таблицей с открытой адресацией и линейным пробированием:
+пары (номер монома, число) лежат прямо в массиве ячеек, размер которого растёт вместе с числом мономов
+и сохраняется при clear(), так что повторно используемое множество не выделяет память заново.
 */
 class MonomialMap{
-	///Тип, определяющий множество с отображением
-	typedef std::unordered_map<MonomialPtr, int, monomialHasher> Container;
-	///отображение мономов в целые числа
-	Container M;//Возможно следует менять размер хеша в зависимости от реальной потребности
+	///ячейка хеш-таблицы; пустая ячейка содержит MonomialTable::noMonomial
+	struct Slot{
+		MonomialID monomial;
+		int value;
+	};
+	///ячейки хеш-таблицы; их число - степень двойки или 0
+	std::vector<Slot> slots;
+	///число занятых ячеек
+	size_t used;
+	///сдвиг, дающий номер начальной ячейки из произведения номера монома на константу
+	int slotShift;
 
 	///тип для отображения чисел на мономы.
-	typedef std::vector<CMonomial> RevMStorgae;
-	///отображение целых чисел в мономы
+	typedef std::vector<MonomialID> RevMStorgae;
+	///отображение целых чисел в номера мономов
 	RevMStorgae revM;
-	/**\details
-	Контейнер используемый для хранения мономов, указатели на которые кладут в hash_map.
-	Дек используется потому что контейнер не должен перемещать элементы при добавлении новых,
-	чтоб не портились указатели.
-	*/
-	std::deque<CMonomial> monomialStorage;
+	///номера мономов в порядке их добавления во множество
+	std::vector<MonomialID> monomialStorage;
+	///позиция в monomialStorage, с которой selectMonomialID() ищет ещё не удалённый моном
+	size_t selectFrom;
+
+	///номер ячейки, с которой начинается поиск монома \a m
+	size_t homeSlot(MonomialID m)const{
+		return size_t((m*uint64_t(0x9E3779B97F4A7C15))>>slotShift);
+	}
+
+	///ячейка с мономом \a m или пустая ячейка, в которую его следует добавить; таблица не должна быть пустой
+	size_t findSlot(MonomialID m)const{
+		const size_t mask=slots.size()-1;
+		size_t s=homeSlot(m);
+		while (slots[s].monomial!=m && slots[s].monomial!=MonomialTable::noMonomial) s=(s+1)&mask;
+		return s;
+	}
+
+	///перестраивает таблицу с \a newSize ячейками (степень двойки)
+	void rehash(size_t newSize){
+		std::vector<Slot> old;
+		old.swap(slots);
+		const Slot empty={MonomialTable::noMonomial,0};
+		slots.assign(newSize,empty);
+		slotShift=64-__builtin_ctzll(newSize);
+		for (const Slot& e: old){
+			if (e.monomial!=MonomialTable::noMonomial) slots[findSlot(e.monomial)]=e;
+		}
+	}
+
+	///возвращает ячейку для монома \a m, добавляя его со значением \a value, если его ещё нет
+	Slot& insert(MonomialID m, int value, bool& inserted){
+		//заполнение таблицы поддерживается не больше половины
+		if (2*(used+1)>slots.size()) rehash(slots.empty() ? 64 : 2*slots.size());
+		Slot& slot=slots[findSlot(m)];
+		inserted=slot.monomial==MonomialTable::noMonomial;
+		if (inserted){
+			slot.monomial=m;
+			slot.value=value;
+			++used;
+		}
+		return slot;
+	}
 
 public:
-	
-	typedef Container::iterator iterator;
-	
-	Container& getMap(){
-		return M;
+	///создаёт множество с местом под \a expectedSize мономов
+	explicit MonomialMap(size_t expectedSize=0):used(0),slotShift(64),selectFrom(0){
+		reserve(expectedSize);
+	}
+
+	///выделяет место под \a expectedSize мономов, чтобы их добавление не перестраивало таблицу
+	void reserve(size_t expectedSize){
+		size_t newSize=slots.empty() ? 64 : slots.size();
+		while (newSize<2*expectedSize) newSize*=2;
+		if (newSize!=slots.size()) rehash(newSize);
+	}
+
+	///очищает множество, сохраняя выделенную память
+	void clear(){
+		const Slot empty={MonomialTable::noMonomial,0};
+		std::fill(slots.begin(),slots.end(),empty);
+		used=0;
+		revM.clear();
+		monomialStorage.clear();
+		selectFrom=0;
 	}
 
 	///возвращает размер множества
 	int size(){
-		return int(M.size());
+		return int(used);
+	}
+
+	///возвращает \c true, если множество содержит моном с номером \a m
+	bool containsMonomial(MonomialID m)const{
+		return used && slots[findSlot(m)].monomial==m;
 	}
 
 	///возвращает \c true, если множество содержит моном \a m
-	bool containsMonomial(const CMonomial& m)const{		
-		return  M.find(MonomialPtr(m))!=M.end();
-	}    
+	template <class Placing> bool containsMonomial(const MonomialWithPlacing<Placing>& m)const{
+		const MonomialID id=globalF4MPI::InternedMonomials.find(m);
+		return id!=MonomialTable::noMonomial && containsMonomial(id);
+	}
+
+	///добавляет моном с номером \a m во множество, если он там еще не содержится
+	void storeMonomial(MonomialID m){
+		bool inserted;
+		insert(m,int(monomialStorage.size()),inserted);
+		if (inserted) monomialStorage.push_back(m);
+	}
 
 	///добавляет моном \a m во множество, если он там еще не содержится
-	void storeMonomial(const CMonomial& m){
-/*
-		Container::value_type objToInsert(MonomialPtr(m),monomialStorage.size());
-		pair<iterator,bool> findingResult=M.insert(objToInsert);
-		if (findingResult.second){//Такого элемента ещё не было
-			monomialStorage.push_back(m);
-			const_cast<MonomialPtr&>(findingResult.first->first)=MonomialPtr(monomialStorage.back());
-		}
-		return findingResult.first->second;
-*/
-		iterator it = M.find(MonomialPtr(m));
-		if(it == M.end()){
-			int newID=monomialStorage.size();
-			monomialStorage.push_back(m);
-			M[MonomialPtr(monomialStorage.back())] = newID;
-		}
+	template <class Placing> void storeMonomial(const MonomialWithPlacing<Placing>& m){
+		storeMonomial(globalF4MPI::InternedMonomials.intern(m));
 	}
 
-	/**возвращает число, сопоставленное моному.
+	/**возвращает число, сопоставленное моному с номером \a m.
 	Упорядочение возвращаемых чисел соотвествуют порядку на мономах, только если после последнего вызова UpdateForUsingReversed()
 	новых мономов не добавлялось.
 	Передаваемый моном \a должен присутствовать в множестве, иначе поведение не определено.
 	*/
-	int getMonomialID(const CMonomial& m)const{
-		return M.find(MonomialPtr(m))->second;
+	int getMonomialID(MonomialID m)const{
+		return slots[findSlot(m)].value;
+	}
+
+	///возвращает число, сопоставленное моному \a m; см. getMonomialID(MonomialID)
+	template <class Placing> int getMonomialID(const MonomialWithPlacing<Placing>& m)const{
+		return getMonomialID(globalF4MPI::InternedMonomials.find(m));
 	}
 
 	///возвращает \c true если множество пустое, \c false иначе
 	bool empty() const {
-		return M.empty();
+		return !used;
 	}
 
-	///удаляет моном \a m из множества.
-	void erase(const CMonomial& m){
-		M.erase(MonomialPtr(m));
+	/**удаляет моном с номером \a m из множества.
+	Следующие за ним в цепочке пробирования элементы сдвигаются назад, поэтому удалённых ячеек-маркеров не остаётся.
+	*/
+	void erase(MonomialID m){
+		if (!used) return;
+		const size_t mask=slots.size()-1;
+		size_t hole=findSlot(m);
+		if (slots[hole].monomial!=m) return;
+		for (size_t j=(hole+1)&mask;slots[j].monomial!=MonomialTable::noMonomial;j=(j+1)&mask){
+			//элемент можно перенести в освободившуюся ячейку, если она не раньше его начальной ячейки
+			if (((j-homeSlot(slots[j].monomial))&mask)>=((j-hole)&mask)){
+				slots[hole]=slots[j];
+				hole=j;
+			}
+		}
+		slots[hole].monomial=MonomialTable::noMonomial;
+		--used;
 	}
 	
-	///возвращает некоторый моном из множества.
-	const CMonomial& selectMonoimial(){		
-		return *(M.begin()->first.ptr);
+	/**возвращает номер некоторого монома из множества.
+	Мономы выбираются в порядке добавления, так что множество можно использовать как очередь,
+	удаляя выбранный моном через erase().
+	*/
+	MonomialID selectMonomialID(){
+		while (!containsMonomial(monomialStorage[selectFrom])) ++selectFrom;
+		return monomialStorage[selectFrom];
 	}
 	
-	/**возвращает моном, соответствующий числу \a i.
+	/**возвращает номер монома, соответствующего числу \a i.
 	Для использзования этой функции необходимо чтоб \a i соответсвовало корректному номеру монома.
 	То есть множество ен должно было меняться с тех пор, как номер был получен от getMonomialID(), вызванной после UpdateForUsingReversed().
 	*/
-	const CMonomial& getMonomialRev(int i)const{
-		return revM[i];			
+	MonomialID getMonomialRevID(int i)const{
+		return revM[i];
+	}
+
+	///возвращает моном, соответствующий числу \a i; см. getMonomialRevID()
+	const CInternalMonomial& getMonomialRev(int i)const{
+		return globalF4MPI::InternedMonomials.get(revM[i]);
 	}
 
 	/**Подготавливает множество мономов к использованию отображений
@@ -167,27 +280,19 @@ public:
 	Более того, функция в силу особенности реализации:
 	\arg добавит назад в множество все удалённые элементы.
 	\arg повторный вызов этой функции приведёт к полной очистке множества.
+
+	Мономы сортируются поразрядной сортировкой (MSD radix sort) по ключам порядка (см. CMonomialBase::orderKey()),
+	а мономы с одинаковыми ключами - сравнением. Крупные части сортируются потоками пула \a pool,
+	и каждый поток сразу же записывает номера своих мономов в таблицу, так что отдельного прохода для её заполнения нет.
 	*/
-	void UpdateForUsingReversed(){
-		revM.clear();
-		M.clear();//все мономы будут вноситься заново
-		revM.resize(monomialStorage.size());
-		std::copy(monomialStorage.begin(),monomialStorage.end(),revM.begin());
-		monomialStorage.clear();//теперь мономы хранятся только в revM
-
-		sort(revM.rbegin(),revM.rend(),monomialHasher());
-		int num=0;
-		for (RevMStorgae::iterator i=revM.begin();i!=revM.end();++i,++num){
-			M[MonomialPtr(*i)]=num;
-		}
-	}
+	void UpdateForUsingReversed(ThreadPool* pool=0);
 
 	///выводит в \a output сопоставление между мономами и числами
 	void PrintMap(std::ostream& output){
-		for(iterator i = M.begin(); i!=M.end(); ++i){
-			CMonomial Ml = *(i->first.ptr);
-			std::string s = Ml.toString();
-			output << "M[" << s << "] = " << i->second << "\n";
+		for(const Slot& e: slots){
+			if (e.monomial==MonomialTable::noMonomial) continue;
+			std::string s = globalF4MPI::InternedMonomials.get(e.monomial).toString();
+			output << "M[" << s << "] = " << e.value << "\n";
 		}
 	}
 
@@ -0,0 +1,105 @@
+/**
+\file
+Реализация общей таблицы мономов
+*/
+#include "monomialtable.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+using namespace std;
+namespace F4MPI{
+
+const MonomialID MonomialTable::noMonomial;
+
+MonomialTable::MonomialTable(){
+	reset();
+}
+
+MonomialTable::~MonomialTable(){
+	for (DegData* b: blocks) delete[] b;
+}
+
+void MonomialTable::reset(){
+	for (DegData* b: blocks) delete[] b;
+	blocks.clear();
+	hashes.clear();
+	slots.assign(1024,noMonomial);
+	//пустой элемент кеша: пара из двух noMonomial никогда не умножается
+	const ProductEntry empty={~uint64_t(0),noMonomial};
+	products.assign(size_t(1)<<productCacheBits,empty);
+	scratch.clear();
+}
+
+size_t MonomialTable::findSlot(const DegData* d, uint32_t h)const{
+	const size_t mask=slots.size()-1;
+	for (size_t s=firstSlot(h);;s=(s+1)&mask){
+		const MonomialID id=slots[s];
+		if (id==noMonomial || (hashes[id]==h && CMonomialBase::isEqual(degrees(id),d))) return s;
+	}
+}
+
+void MonomialTable::grow(){
+	slots.assign(slots.size()*2,noMonomial);
+	const size_t mask=slots.size()-1;
+	for (MonomialID id=0;id<hashes.size();++id){
+		size_t s=firstSlot(hashes[id]);
+		while (slots[s]!=noMonomial) s=(s+1)&mask;
+		slots[s]=id;
+	}
+}
+
+MonomialID MonomialTable::find(const DegData* d)const{
+	return slots[findSlot(d,shortHash(d))];
+}
+
+MonomialID MonomialTable::intern(const DegData* d){
+	const uint32_t h=shortHash(d);
+	size_t s=findSlot(d,h);
+	if (slots[s]!=noMonomial) return slots[s];
+	const MonomialID id=MonomialID(hashes.size());
+	if (id==noMonomial) throw std::length_error("too many distinct monomials");
+	if (!(id&((1<<blockBits)-1))) blocks.push_back(new DegData[size_t(CMonomialBase::degreessize)<<blockBits]);
+	memcpy(blocks.back()+size_t(id&((1<<blockBits)-1))*CMonomialBase::degreessize,d,CMonomialBase::degreessize);
+	hashes.push_back(h);
+	//заполнение таблицы поддерживается не больше половины
+	if (2*hashes.size()>slots.size()){
+		grow();
+	}else{
+		slots[s]=id;
+	}
+	return id;
+}
+
+MonomialID MonomialTable::mul(MonomialID a, MonomialID b){
+	if (a>b) swap(a,b);
+	const uint64_t factors=(uint64_t(a)<<32)|b;
+	ProductEntry& e=products[(factors*uint64_t(0x9E3779B97F4A7C15))>>(64-productCacheBits)];
+	if (e.factors!=factors){
+		scratch.resize(CMonomialBase::degreessize);
+		CMonomialBase::mul(degrees(a),degrees(b),&scratch[0]);
+		e.product=intern(&scratch[0]);
+		e.factors=factors;
+	}
+	return e.product;
+}
+
+MonomialID MonomialTable::findQuotient(MonomialID a, MonomialID b, DegData* result)const{
+	if (!CMonomialBase::tryDiv(degrees(a),degrees(b),result)) throw std::logic_error("monomial is not divisible");
+	return find(result);
+}
+
+MonomialID MonomialTable::findProduct(MonomialID a, MonomialID b, DegData* result)const{
+	if (a>b) swap(a,b);
+	const uint64_t factors=(uint64_t(a)<<32)|b;
+	const ProductEntry& e=products[(factors*uint64_t(0x9E3779B97F4A7C15))>>(64-productCacheBits)];
+	if (e.factors==factors) return e.product;
+	return findProduct(degrees(a),b,result);
+}
+
+MonomialID MonomialTable::findProduct(const DegData* a, MonomialID b, DegData* result)const{
+	CMonomialBase::mul(a,degrees(b),result);
+	return find(result);
+}
+} //namespace F4MPI
@@ -0,0 +1,196 @@
+#ifndef MonomialTable_h
+#define MonomialTable_h
+/**
+\file
+Общая таблица мономов.
+Каждый моном, встречающийся в многочленах, хранится в таблице один раз и обозначается 32-битным номером #MonomialID.
+Многочлены хранят номера мономов вместо их данных: равенство мономов сводится к сравнению номеров,
+а соответствие мономов столбцам матрицы строится по номерам без хеширования степеней.
+*/
+
+#include "cmonomial.h"
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace F4MPI{
+///номер монома в MonomialTable
+typedef uint32_t MonomialID;
+
+/**множество всех мономов кольца с нумерацией.
+Мономы добавляются в таблицу и никогда не удаляются и не перемещаются до вызова reset(),
+поэтому номера и ссылки на данные мономов действительны всё это время.
+Произведения мономов запоминаются в кеше прямого отображения фиксированного размера,
+так что повторное умножение одних и тех же мономов не требует ни сложения степеней, ни поиска в таблице.
+Таблица не потокобезопасна.
+*/
+class MonomialTable{
+	typedef CMonomialBase::DegData DegData;
+	///двоичный логарифм числа мономов в одном блоке хранилища
+	static const int blockBits=12;
+	///двоичный логарифм числа элементов кеша произведений
+	static const int productCacheBits=18;
+
+	///запомненное произведение; factors - упорядоченная пара номеров сомножителей
+	struct ProductEntry{
+		uint64_t factors;
+		MonomialID product;
+	};
+
+	///блоки по 2^blockBits мономов размера CMonomialBase::degreessize
+	std::vector<DegData*> blocks;
+	///хеши мономов по номерам
+	std::vector<uint32_t> hashes;
+	///хеш-таблица с открытой адресацией, содержащая номера мономов или noMonomial; размер - степень двойки
+	std::vector<MonomialID> slots;
+	///кеш произведений, элемент выбирается по хешу пары сомножителей
+	std::vector<ProductEntry> products;
+	///место для вычисления произведения перед его поиском в таблице
+	std::vector<DegData> scratch;
+
+	///хранимый в мономе хеш (см. CMonomialBase::hash()), свёрнутый до 32 бит
+	static uint32_t shortHash(const DegData* d){
+		const uint64_t h=CMonomialBase::hash(d);
+		return uint32_t(h)^uint32_t(h>>32);
+	}
+
+	///номер ячейки slots, с которой начинается поиск монома с хешем \a h
+	size_t firstSlot(uint32_t h)const{
+		return (h*uint64_t(0x9E3779B97F4A7C15))>>(64-__builtin_ctzll(slots.size()));
+	}
+
+	///ищет моном в slots; возвращает ячейку с ним или пустую ячейку, куда его следует добавить
+	size_t findSlot(const DegData* d, uint32_t h)const;
+
+	///увеличивает slots вдвое
+	void grow();
+
+	MonomialTable(const MonomialTable&);//запрет на копирование
+	void operator=(const MonomialTable&);
+  public:
+	///номер, не соответствующий никакому моному
+	static const MonomialID noMonomial=~MonomialID(0);
+
+	MonomialTable();
+	~MonomialTable();
+
+	/**удаляет все мономы.
+	Необходимо вызывать при изменении CMonomialBase::degreessize (т.е. при переходе к другому кольцу),
+	после чего все ранее полученные номера некорректны.
+	*/
+	void reset();
+
+	///число мономов в таблице
+	size_t size()const{
+		return hashes.size();
+	}
+
+	///данные монома с номером \a id
+	const DegData* degrees(MonomialID id)const{
+		return blocks[id>>blockBits]+size_t(id&((1<<blockBits)-1))*CMonomialBase::degreessize;
+	}
+
+	///моном с номером \a id
+	const CInternalMonomial& get(MonomialID id)const{
+		return *reinterpret_cast<const CInternalMonomial*>(degrees(id));
+	}
+
+	///номер монома с данными \a d или noMonomial, если его нет в таблице
+	MonomialID find(const DegData* d)const;
+
+	///номер монома с данными \a d; моном добавляется в таблицу, если его там ещё нет
+	MonomialID intern(const DegData* d);
+
+	template <class Placing> MonomialID find(const MonomialWithPlacing<Placing>& m)const{
+		return find(m.degrees);
+	}
+
+	template <class Placing> MonomialID intern(const MonomialWithPlacing<Placing>& m){
+		return intern(m.degrees);
+	}
+
+	///номер произведения мономов \a a и \a b
+	MonomialID mul(MonomialID a, MonomialID b);
+
+	/**\details
+	Функции поиска частного и произведений мономов только читают таблицу и кеш произведений,
+	поэтому их можно вызывать из нескольких потоков одновременно, пока таблица не изменяется.
+	Они возвращают номер результата или noMonomial, если результата ещё нет в таблице;
+	тогда данные результата записываются в \a result (CMonomialBase::degreessize байт) для последующего intern().
+	*/
+	///частное от деления монома \a a на моном \a b, который должен его делить
+	MonomialID findQuotient(MonomialID a, MonomialID b, DegData* result)const;
+
+	///произведение мономов \a a и \a b (см. findQuotient())
+	MonomialID findProduct(MonomialID a, MonomialID b, DegData* result)const;
+
+	///произведение монома с данными \a a и монома \a b (см. findQuotient())
+	MonomialID findProduct(const DegData* a, MonomialID b, DegData* result)const;
+};
+} //namespace F4MPI
+
+namespace globalF4MPI{
+	///таблица мономов текущего кольца, в которой хранятся мономы всех многочленов
+	extern F4MPI::MonomialTable InternedMonomials;
+}
+
+namespace F4MPI{
+/**итератор по массиву номеров мономов.
+Разыменование даёт моном из таблицы globalF4MPI::InternedMonomials, поэтому изменять мономы через итератор нельзя.
+*/
+class InternedMonomialIterator{
+	const MonomialID* pos;
+  public:
+	InternedMonomialIterator():pos(0){}
+	explicit InternedMonomialIterator(const MonomialID* p):pos(p){}
+
+	const CInternalMonomial& operator*()const{
+		return globalF4MPI::InternedMonomials.get(*pos);
+	}
+
+	const CInternalMonomial* operator->()const{
+		return &**this;
+	}
+
+	///номер монома, на который указывает итератор
+	MonomialID id()const{
+		return *pos;
+	}
+
+	bool operator==(InternedMonomialIterator v)const{
+		return pos==v.pos;
+	}
+
+	bool operator!=(InternedMonomialIterator v)const{
+		return pos!=v.pos;
+	}
+
+	ptrdiff_t operator-(InternedMonomialIterator v)const{
+		return pos-v.pos;
+	}
+
+	InternedMonomialIterator& operator++(){
+		++pos;
+		return *this;
+	}
+
+	InternedMonomialIterator& operator--(){
+		--pos;
+		return *this;
+	}
+
+	InternedMonomialIterator operator++(int){
+		InternedMonomialIterator tmp=*this;
+		++pos;
+		return tmp;
+	}
+
+	InternedMonomialIterator operator--(int){
+		InternedMonomialIterator tmp=*this;
+		--pos;
+		return tmp;
+	}
+};
+} //namespace F4MPI
+#endif
@@ -4,6 +4,7 @@
 
 #include "outputroutines.h"
 #include "conversions.h"
+#include "spairs.h"
 
 using namespace std;
 namespace F4MPI{
@@ -64,11 +65,11 @@ void PrintSPairSet(ostream& output,SPairSet& pairs){
 		output<<"empty\n";
 		return;
 	}
-	for(SPairSet::iterator i = pairs.begin(); i!=pairs.end(); ++i){		
+	for(const auto& p: pairs.pairs()){
 		output<<"{";
-		i->first.printPolynomial(output);
+		pairs.poly(p.first).printPolynomial(output);
 		output<<", ";
-		i->second.printPolynomial(output);
+		pairs.poly(p.second).printPolynomial(output);
 		output<<"}\n";
 	}
 }
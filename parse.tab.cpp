@@ -1739,6 +1739,12 @@ int ParseInput (istream& ins, PolynomSet& readSet, ParserVarNames* varNames){
 			return -1;
 		}
 		F4MPIPolyParser::yyparse();
+	}catch(const DegreeOverflow&){
+		//не ошибка разбора: вызывающий может повторить разбор с большей шириной степеней
+		F4MPIPolyParser::freeParseMem();
+		F4MPIPolyParser::ParserPolynomialSet.clear();
+		F4MPIPolyParser::varname2poly.clear();
+		throw;
 	}catch(const std::exception& e){
 		fprintf(stderr, "Parse error: %s\n", e.what());
 		F4MPIPolyParser::freeParseMem();
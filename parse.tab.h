@@ -13,6 +13,8 @@ namespace F4MPI{
 \param readSet множество, в которое будет записано считанное множество
 \param varNames указатель на переменную, в которую следует сохранить соответствие между номерами переменных в представлении монома и их текстовыми именами.
 \retval успешность завершения. 0 - успешное, \<0 - произошла ошибка
+\throws DegreeOverflow если степени задачи не помещаются в текущую ширину степеней (globalOptions.degreeBytes)
+или переменные монома - в ёмкость разреженных мономов (globalOptions.sparseTerms)
 */
 int ParseInput (std::istream& ins, PolynomSet& readSet, ParserVarNames* varNames);
 } //namespace F4MPI
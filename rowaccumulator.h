@@ -0,0 +1,162 @@
+#ifndef RowAccumulator_h
+#define RowAccumulator_h
+/**
+\file
+Плотный аккумулятор для редукции строк матрицы.
+Строка разворачивается в плотный массив 64-битных сумм, к которому прибавляются редуцирующие строки
+без взятия по модулю после каждого умножения. Приведение по модулю производится лишь тогда,
+когда дальнейшие сложения могут привести к переполнению, и при обратном сворачивании в разреженную строку.
+*/
+
+#include "cmatrix.h"
+#include "csrmatrix.h"
+#include "modpolicy.h"
+#include "simdkernels.h"
+
+#include <vector>
+#include <limits>
+#include <cstdint>
+#include <cstring>
+
+namespace F4MPI{
+/**Плотный аккумулятор строки.
+Хранит одну редуцируемую строку в виде плотного массива неприведённых по модулю сумм.
+Между вызовами load() и store() все элементы массива вне рабочего диапазона [begin();end()) нулевые,
+поэтому один аккумулятор переиспользуется для редукции многих строк без повторной очистки.
+Арифметика по модулю выполняется через политику \a Modulus (см. modpolicy.h).
+*/
+template <class Modulus>
+class DenseRowAccumulator{
+	typedef uint64_t Acc;
+	///неприведённые суммы по столбцам
+	std::vector<Acc> acc;
+	///рабочий диапазон столбцов, вне которого все суммы нулевые
+	int lo, hi;
+	///модуль, по которому ведутся вычисления
+	Modulus mod;
+	///максимальное число умножений-сложений после приведения по модулю, не приводящее к переполнению
+	Acc maxAdds;
+	///число умножений-сложений, которые ещё можно выполнить без приведения по модулю
+	Acc addsLeft;
+	///буфер для сворачивания результата
+	std::vector<RowElement> gathered;
+
+	///приводит по модулю все суммы рабочего диапазона
+	void reduceAll(){
+		for (int c=lo;c<hi;++c){
+			acc[c]=mod.reduce(acc[c]);
+		}
+		addsLeft=maxAdds;
+	}
+
+	static CModular fromReduced(Acc v){
+		return CModular::fromReduced(int(v));
+	}
+
+	///прибавляет \a n элементов со столбцами \a columns и значениями \a values, домноженных на \a m
+	void addScaled(const int* columns, const uint16_t* values, int n, Acc m){
+		SIMD::scatterAddScaled(acc.data(),columns,values,n,m);
+	}
+
+	void addScaled(const int* columns, const CModular* values, int n, Acc m){
+		SIMD::scatterAddScaled(acc.data(),columns,reinterpret_cast<const int32_t*>(values),n,m);
+	}
+
+  public:
+	DenseRowAccumulator(const Modulus& modulus, int columns):lo(0),hi(0),mod(modulus),addsLeft(0){
+		//до приведения элементы меньше p, каждое сложение добавляет не более (p-1)^2
+		const Acc p=mod.value();
+		const Acc maxProduct=(p-1)*(p-1);
+		maxAdds=maxProduct ? (std::numeric_limits<Acc>::max()-(p-1))/maxProduct : std::numeric_limits<Acc>::max();
+		resize(columns);
+	}
+
+	/**устанавливает число столбцов.
+	Должна вызываться, когда аккумулятор пуст (перед load() или после store()).
+	*/
+	void resize(int columns){
+		if (int(acc.size())<columns) acc.resize(columns,0);
+	}
+
+	///разворачивает строку \a row в аккумулятор
+	void load(const CRow& row){
+		lo=hi=0;
+		addsLeft=maxAdds;
+		if (row.empty()) return;
+		for (CRow::const_iterator i=row.begin();i!=row.end();++i){
+			acc[i->column]=Acc(i->value.toint());
+		}
+		lo=row.HM();
+		hi=row.back().column+1;
+	}
+
+	///начало рабочего диапазона столбцов
+	int begin()const{
+		return lo;
+	}
+
+	///конец рабочего диапазона столбцов (может расти при прибавлении строк)
+	int end()const{
+		return hi;
+	}
+
+	///возвращает приведённое значение в столбце \a column
+	CModular coefAt(int column){
+		Acc v=acc[column];
+		if (!v) return CModular();
+		v=mod.reduce(v);
+		acc[column]=v;
+		return fromReduced(v);
+	}
+
+	///прибавляет строку \a by, домноженную на \a mult
+	void addMultiplied(const CRow& by, CModular mult){
+		if (by.empty() || mult==0) return;
+		if (!addsLeft) reduceAll();
+		--addsLeft;
+		static_assert(sizeof(RowElement)==2*sizeof(int32_t),"RowElement must be a (column, value) pair of 32-bit integers");
+		SIMD::scatterAddScaledPairs(acc.data(),reinterpret_cast<const int32_t*>(&by.front()),int(by.size()),Acc(mult.toint()));
+		if (lo==hi) lo=by.HM();
+		else lo=std::min(lo,by.HM());
+		hi=std::max(hi,by.back().column+1);
+	}
+
+	///прибавляет строку \a by непрерывно хранимой матрицы, домноженную на \a mult
+	void addMultiplied(const CSRRow& by, CModular mult){
+		if (by.empty() || mult==0) return;
+		if (!addsLeft) reduceAll();
+		--addsLeft;
+		const Acc m=Acc(mult.toint());
+		if (by.values16){
+			addScaled(by.columns,by.values16,by.size,m);
+		}else{
+			addScaled(by.columns,by.values,by.size,m);
+		}
+		if (lo==hi) lo=by.HM();
+		else lo=std::min(lo,by.HM());
+		hi=std::max(hi,by.lastColumn()+1);
+	}
+
+	/**сворачивает аккумулятор в разреженную строку \a row.
+	Нулевые по модулю элементы отбрасываются, аккумулятор после этого снова пуст.
+	*/
+	void store(CRow& row){
+		gathered.clear();
+		const Acc* const a=acc.data();
+		for (int c=SIMD::findNonZero(a,lo,hi);c<hi;c=SIMD::findNonZero(a,c+1,hi)){
+			Acc v=acc[c];
+			acc[c]=0;
+			v=mod.reduce(v);
+			if (!v) continue;
+			RowElement e;
+			e.column=c;
+			e.value=fromReduced(v);
+			gathered.push_back(e);
+		}
+		lo=hi=0;
+		row.resize(gathered.size());
+		if (!gathered.empty()) memcpy(&row.front(),&gathered.front(),gathered.size()*sizeof(RowElement));
+	}
+};
+} //namespace F4MPI
+#endif
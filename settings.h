@@ -3,9 +3,11 @@
 #include "libf4mpi.h"
 #include "mpi_start_info.h"
 #include "matrixinfoimpl.h"
+#include "threadpool.h"
 
 #include <iosfwd>
 #include <vector>
+#include <memory>
 /**\file
 стуктуры статистики и параметров F4
 */
@@ -37,7 +39,9 @@ struct F4AlgData:F4AlgOptions{
 			mpi_start_info(a_mpi_start_info),
 			stats(f4stats),
 			latex_log(a_latex_log)
-	{}
+	{
+		if (numberOfThreads>1) threadPool.reset(new ThreadPool(numberOfThreads));
+	}
 
 	const MPIStartInfo &mpi_start_info;
 
@@ -47,6 +51,9 @@ struct F4AlgData:F4AlgOptions{
 	///stream for writing latex log
 	std::ostream* latex_log;
 
+	///пул потоков для редукции матриц или NULL, если используется один поток
+	std::unique_ptr<ThreadPool> threadPool;
+
 };
 
 } //namespace F4MPI
@@ -0,0 +1,337 @@
+/**
+\file
+Реализация векторных ядер для операций над строками.
+Векторные варианты компилируются с атрибутом target, поэтому не требуют включения AVX для всего проекта
+и вызываются только после проверки возможностей процессора.
+*/
+#include "simdkernels.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define F4MPI_SIMD_X86 1
+#include <immintrin.h>
+#else
+#define F4MPI_SIMD_X86 0
+#endif
+
+namespace F4MPI{
+namespace SIMD{
+
+namespace{
+///наибольший модуль, для которого произведение двух вычетов помещается в 32 бита
+const uint32_t maxShortModulus=1u<<16;
+
+Level detectLevel(){
+#if F4MPI_SIMD_X86
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx512f")) return LEVEL_AVX512;
+	if (__builtin_cpu_supports("avx2")) return LEVEL_AVX2;
+#endif
+	return LEVEL_SCALAR;
+}
+
+Level& currentLevel(){
+	static Level level=detectedLevel();
+	return level;
+}
+
+//скалярные реализации; векторные реализации обрабатывают ими остатки массивов
+
+void mulModScalar(int32_t* values, int n, int stride, uint32_t c, uint32_t p){
+	for (int i=0;i<n;++i){
+		int32_t& v=values[i*stride];
+		v=int32_t(uint64_t(uint32_t(v))*c%p);
+	}
+}
+
+template <class Value>
+void scatterAddScaledScalar(uint64_t* acc, const int* columns, const Value* values, int n, uint64_t m){
+	for (int i=0;i<n;++i){
+		acc[columns[i]]+=m*uint32_t(values[i]);
+	}
+}
+
+void scatterAddScaledPairsScalar(uint64_t* acc, const int32_t* pairs, int n, uint64_t m){
+	for (int i=0;i<n;++i){
+		acc[pairs[2*i]]+=m*uint32_t(pairs[2*i+1]);
+	}
+}
+
+void addScaledDenseScalar(uint64_t* acc, const uint32_t* values, int n, uint64_t m){
+	for (int i=0;i<n;++i){
+		acc[i]+=m*values[i];
+	}
+}
+
+int findNonZeroScalar(const uint64_t* a, int from, int to){
+	while (from<to && !a[from]) ++from;
+	return from;
+}
+
+#if F4MPI_SIMD_X86
+/*Произведение x двух вычетов по модулю p<=2^16 меньше 2^32, поэтому остаток вычисляется редукцией Барретта
+с m=floor(2^32/p): частное q=(x*m)>>32 меньше точного не более чем на 1, а x-q*p<2p.
+Все величины лежат в младших 32 битах 64-битных элементов вектора.*/
+
+__attribute__((target("avx2")))
+inline __m256i mulModAVX2(__m256i v, __m256i c, __m256i p, __m256i m){
+	__m256i x=_mm256_mul_epu32(v,c);
+	__m256i q=_mm256_srli_epi64(_mm256_mul_epu32(x,m),32);
+	__m256i r=_mm256_sub_epi64(x,_mm256_mul_epu32(q,p));
+	//r>=p, сравнение со знаком верно, так как r<2^32
+	return _mm256_sub_epi64(r,_mm256_andnot_si256(_mm256_cmpgt_epi64(p,r),p));
+}
+
+__attribute__((target("avx2")))
+void mulModContiguousAVX2(int32_t* values, int n, uint32_t c, uint32_t p){
+	const __m256i cv=_mm256_set1_epi64x(c);
+	const __m256i pv=_mm256_set1_epi64x(p);
+	const __m256i mv=_mm256_set1_epi64x((uint64_t(1)<<32)/p);
+	int i=0;
+	for (;i+8<=n;i+=8){
+		__m256i v=_mm256_loadu_si256((const __m256i*)(values+i));
+		__m256i even=mulModAVX2(v,cv,pv,mv);
+		__m256i odd=mulModAVX2(_mm256_srli_epi64(v,32),cv,pv,mv);
+		_mm256_storeu_si256((__m256i*)(values+i),_mm256_or_si256(even,_mm256_slli_epi64(odd,32)));
+	}
+	mulModScalar(values+i,n-i,1,c,p);
+}
+
+__attribute__((target("avx2")))
+void mulModPairsAVX2(int32_t* pairs, int n, uint32_t c, uint32_t p){
+	const __m256i cv=_mm256_set1_epi64x(c);
+	const __m256i pv=_mm256_set1_epi64x(p);
+	const __m256i mv=_mm256_set1_epi64x((uint64_t(1)<<32)/p);
+	const __m256i lowHalf=_mm256_set1_epi64x(0xFFFFFFFFu);
+	int i=0;
+	for (;i+4<=n;i+=4){
+		__m256i v=_mm256_loadu_si256((const __m256i*)(pairs+2*i));
+		__m256i r=mulModAVX2(_mm256_srli_epi64(v,32),cv,pv,mv);
+		_mm256_storeu_si256((__m256i*)(pairs+2*i),_mm256_or_si256(_mm256_and_si256(v,lowHalf),_mm256_slli_epi64(r,32)));
+	}
+	mulModScalar(pairs+2*i+1,n-i,2,c,p);
+}
+
+__attribute__((target("avx2")))
+void addScaledDenseAVX2(uint64_t* acc, const uint32_t* values, int n, uint64_t m){
+	const __m256i mv=_mm256_set1_epi64x(m);
+	int i=0;
+	for (;i+4<=n;i+=4){
+		__m256i v=_mm256_cvtepu32_epi64(_mm_loadu_si128((const __m128i*)(values+i)));
+		__m256i a=_mm256_loadu_si256((const __m256i*)(acc+i));
+		_mm256_storeu_si256((__m256i*)(acc+i),_mm256_add_epi64(a,_mm256_mul_epu32(v,mv)));
+	}
+	addScaledDenseScalar(acc+i,values+i,n-i,m);
+}
+
+__attribute__((target("avx2")))
+int findNonZeroAVX2(const uint64_t* a, int from, int to){
+	for (;from+4<=to;from+=4){
+		__m256i v=_mm256_loadu_si256((const __m256i*)(a+from));
+		if (!_mm256_testz_si256(v,v)) break;
+	}
+	return findNonZeroScalar(a,from,to);
+}
+
+//в GCC 12 промежуточные значения _mm512_undefined_epi32() внутри встроенных функций дают ложные предупреждения
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+
+__attribute__((target("avx512f")))
+inline __m512i mulModAVX512(__m512i v, __m512i c, __m512i p, __m512i m){
+	__m512i x=_mm512_mul_epu32(v,c);
+	__m512i q=_mm512_srli_epi64(_mm512_mul_epu32(x,m),32);
+	__m512i r=_mm512_sub_epi64(x,_mm512_mul_epu32(q,p));
+	return _mm512_mask_sub_epi64(r,_mm512_cmpge_epu64_mask(r,p),r,p);
+}
+
+__attribute__((target("avx512f")))
+void mulModContiguousAVX512(int32_t* values, int n, uint32_t c, uint32_t p){
+	const __m512i cv=_mm512_set1_epi64(c);
+	const __m512i pv=_mm512_set1_epi64(p);
+	const __m512i mv=_mm512_set1_epi64((uint64_t(1)<<32)/p);
+	int i=0;
+	for (;i+16<=n;i+=16){
+		__m512i v=_mm512_loadu_si512(values+i);
+		__m512i even=mulModAVX512(v,cv,pv,mv);
+		__m512i odd=mulModAVX512(_mm512_srli_epi64(v,32),cv,pv,mv);
+		_mm512_storeu_si512(values+i,_mm512_or_si512(even,_mm512_slli_epi64(odd,32)));
+	}
+	mulModScalar(values+i,n-i,1,c,p);
+}
+
+__attribute__((target("avx512f")))
+void mulModPairsAVX512(int32_t* pairs, int n, uint32_t c, uint32_t p){
+	const __m512i cv=_mm512_set1_epi64(c);
+	const __m512i pv=_mm512_set1_epi64(p);
+	const __m512i mv=_mm512_set1_epi64((uint64_t(1)<<32)/p);
+	const __m512i lowHalf=_mm512_set1_epi64(0xFFFFFFFFu);
+	int i=0;
+	for (;i+8<=n;i+=8){
+		__m512i v=_mm512_loadu_si512(pairs+2*i);
+		__m512i r=mulModAVX512(_mm512_srli_epi64(v,32),cv,pv,mv);
+		_mm512_storeu_si512(pairs+2*i,_mm512_or_si512(_mm512_and_si512(v,lowHalf),_mm512_slli_epi64(r,32)));
+	}
+	mulModScalar(pairs+2*i+1,n-i,2,c,p);
+}
+
+/*Номера столбцов одной строки различны, поэтому элементы, собираемые одной командой gather,
+не пересекаются и scatter не теряет сложений.*/
+
+__attribute__((target("avx512f")))
+void scatterAddScaledAVX512(uint64_t* acc, const int* columns, const uint16_t* values, int n, uint64_t m){
+	const __m512i mv=_mm512_set1_epi64(m);
+	int i=0;
+	for (;i+8<=n;i+=8){
+		__m256i idx=_mm256_loadu_si256((const __m256i*)(columns+i));
+		__m512i v=_mm512_cvtepu16_epi64(_mm_loadu_si128((const __m128i*)(values+i)));
+		__m512i a=_mm512_i32gather_epi64(idx,(const void*)acc,8);
+		_mm512_i32scatter_epi64((void*)acc,idx,_mm512_add_epi64(a,_mm512_mul_epu32(v,mv)),8);
+	}
+	scatterAddScaledScalar(acc,columns+i,values+i,n-i,m);
+}
+
+__attribute__((target("avx512f")))
+void scatterAddScaledAVX512(uint64_t* acc, const int* columns, const int32_t* values, int n, uint64_t m){
+	const __m512i mv=_mm512_set1_epi64(m);
+	int i=0;
+	for (;i+8<=n;i+=8){
+		__m256i idx=_mm256_loadu_si256((const __m256i*)(columns+i));
+		__m512i v=_mm512_cvtepu32_epi64(_mm256_loadu_si256((const __m256i*)(values+i)));
+		__m512i a=_mm512_i32gather_epi64(idx,(const void*)acc,8);
+		_mm512_i32scatter_epi64((void*)acc,idx,_mm512_add_epi64(a,_mm512_mul_epu32(v,mv)),8);
+	}
+	scatterAddScaledScalar(acc,columns+i,values+i,n-i,m);
+}
+
+__attribute__((target("avx512f")))
+void scatterAddScaledPairsAVX512(uint64_t* acc, const int32_t* pairs, int n, uint64_t m){
+	const __m512i mv=_mm512_set1_epi64(m);
+	int i=0;
+	for (;i+8<=n;i+=8){
+		//младшие половины 64-битных элементов - номера столбцов, старшие - значения
+		__m512i v=_mm512_loadu_si512(pairs+2*i);
+		__m256i idx=_mm512_cvtepi64_epi32(v);
+		__m512i a=_mm512_i32gather_epi64(idx,(const void*)acc,8);
+		_mm512_i32scatter_epi64((void*)acc,idx,_mm512_add_epi64(a,_mm512_mul_epu32(_mm512_srli_epi64(v,32),mv)),8);
+	}
+	scatterAddScaledPairsScalar(acc,pairs+2*i,n-i,m);
+}
+
+__attribute__((target("avx512f")))
+void addScaledDenseAVX512(uint64_t* acc, const uint32_t* values, int n, uint64_t m){
+	const __m512i mv=_mm512_set1_epi64(m);
+	int i=0;
+	for (;i+8<=n;i+=8){
+		__m512i v=_mm512_cvtepu32_epi64(_mm256_loadu_si256((const __m256i*)(values+i)));
+		__m512i a=_mm512_loadu_si512(acc+i);
+		_mm512_storeu_si512(acc+i,_mm512_add_epi64(a,_mm512_mul_epu32(v,mv)));
+	}
+	addScaledDenseScalar(acc+i,values+i,n-i,m);
+}
+
+__attribute__((target("avx512f")))
+int findNonZeroAVX512(const uint64_t* a, int from, int to){
+	for (;from+8<=to;from+=8){
+		__m512i v=_mm512_loadu_si512(a+from);
+		__mmask8 nonZero=_mm512_test_epi64_mask(v,v);
+		if (nonZero) return from+__builtin_ctz(nonZero);
+	}
+	return findNonZeroScalar(a,from,to);
+}
+#pragma GCC diagnostic pop
+#endif //F4MPI_SIMD_X86
+} //namespace
+
+Level detectedLevel(){
+	static const Level level=detectLevel();
+	return level;
+}
+
+Level activeLevel(){
+	return currentLevel();
+}
+
+void setMaxLevel(Level maxLevel){
+	currentLevel()=maxLevel<detectedLevel() ? maxLevel : detectedLevel();
+}
+
+void mulModContiguous(int32_t* values, int n, uint32_t c, uint32_t p){
+#if F4MPI_SIMD_X86
+	if (p<=maxShortModulus){
+		switch(currentLevel()){
+			case LEVEL_AVX512: mulModContiguousAVX512(values,n,c,p); return;
+			case LEVEL_AVX2: mulModContiguousAVX2(values,n,c,p); return;
+			default: break;
+		}
+	}
+#endif
+	mulModScalar(values,n,1,c,p);
+}
+
+void mulModPairs(int32_t* pairs, int n, uint32_t c, uint32_t p){
+#if F4MPI_SIMD_X86
+	if (p<=maxShortModulus){
+		switch(currentLevel()){
+			case LEVEL_AVX512: mulModPairsAVX512(pairs,n,c,p); return;
+			case LEVEL_AVX2: mulModPairsAVX2(pairs,n,c,p); return;
+			default: break;
+		}
+	}
+#endif
+	mulModScalar(pairs+1,n,2,c,p);
+}
+
+void scatterAddScaled(uint64_t* acc, const int* columns, const uint16_t* values, int n, uint64_t m){
+#if F4MPI_SIMD_X86
+	//в AVX2 нет команды scatter, и векторный вариант не быстрее скалярного
+	if (currentLevel()==LEVEL_AVX512){
+		scatterAddScaledAVX512(acc,columns,values,n,m);
+		return;
+	}
+#endif
+	scatterAddScaledScalar(acc,columns,values,n,m);
+}
+
+void scatterAddScaled(uint64_t* acc, const int* columns, const int32_t* values, int n, uint64_t m){
+#if F4MPI_SIMD_X86
+	if (currentLevel()==LEVEL_AVX512){
+		scatterAddScaledAVX512(acc,columns,values,n,m);
+		return;
+	}
+#endif
+	scatterAddScaledScalar(acc,columns,values,n,m);
+}
+
+void scatterAddScaledPairs(uint64_t* acc, const int32_t* pairs, int n, uint64_t m){
+#if F4MPI_SIMD_X86
+	if (currentLevel()==LEVEL_AVX512){
+		scatterAddScaledPairsAVX512(acc,pairs,n,m);
+		return;
+	}
+#endif
+	scatterAddScaledPairsScalar(acc,pairs,n,m);
+}
+
+void addScaledDense(uint64_t* acc, const uint32_t* values, int n, uint64_t m){
+#if F4MPI_SIMD_X86
+	switch(currentLevel()){
+		case LEVEL_AVX512: addScaledDenseAVX512(acc,values,n,m); return;
+		case LEVEL_AVX2: addScaledDenseAVX2(acc,values,n,m); return;
+		default: break;
+	}
+#endif
+	addScaledDenseScalar(acc,values,n,m);
+}
+
+int findNonZero(const uint64_t* a, int from, int to){
+#if F4MPI_SIMD_X86
+	switch(currentLevel()){
+		case LEVEL_AVX512: return findNonZeroAVX512(a,from,to);
+		case LEVEL_AVX2: return findNonZeroAVX2(a,from,to);
+		default: break;
+	}
+#endif
+	return findNonZeroScalar(a,from,to);
+}
+} //namespace SIMD
+} //namespace F4MPI
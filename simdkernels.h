@@ -0,0 +1,66 @@
+#ifndef SimdKernels_h
+#define SimdKernels_h
+/**
+\file
+Векторные (SIMD) ядра для операций над строками матрицы.
+Каждое ядро имеет скалярную реализацию и реализации на AVX2 и AVX-512,
+выбираемые во время выполнения по возможностям процессора.
+Все реализации выполняют точные целочисленные вычисления и дают одинаковые результаты.
+*/
+
+#include <cstdint>
+
+namespace F4MPI{
+namespace SIMD{
+///набор векторных инструкций, используемый ядрами
+enum Level{
+	LEVEL_SCALAR=0,
+	LEVEL_AVX2=1,
+	LEVEL_AVX512=2
+};
+
+///наилучший набор инструкций, поддерживаемый процессором
+Level detectedLevel();
+
+///набор инструкций, используемый ядрами в данный момент
+Level activeLevel();
+
+/**ограничивает используемый ядрами набор инструкций уровнем \a maxLevel.
+Используется для сравнения реализаций и отладки; уровень выше поддерживаемого процессором не включается.
+Не должна вызываться одновременно с выполнением ядер.
+*/
+void setMaxLevel(Level maxLevel);
+
+/**домножает по модулю \a p на \a c каждый из \a n вычетов, расположенных подряд в \a values.
+\a c и все значения должны быть меньше \a p.
+*/
+void mulModContiguous(int32_t* values, int n, uint32_t c, uint32_t p);
+
+/**домножает по модулю \a p на \a c значения в \a n парах (номер столбца, значение), расположенных подряд в \a pairs.
+Соответствует раскладке RowElement; номера столбцов не меняются.
+*/
+void mulModPairs(int32_t* pairs, int n, uint32_t c, uint32_t p);
+
+/**прибавляет к 64-битным суммам \a acc в столбцах \a columns значения \a values, домноженные на \a m.
+Номера столбцов должны быть различны, \a m и значения меньше 2^32.
+*/
+void scatterAddScaled(uint64_t* acc, const int* columns, const uint16_t* values, int n, uint64_t m);
+
+///то же, что и предыдущая, для 32-битных значений
+void scatterAddScaled(uint64_t* acc, const int* columns, const int32_t* values, int n, uint64_t m);
+
+/**то же для \a n пар (номер столбца, значение), расположенных подряд в \a pairs.
+Соответствует раскладке RowElement.
+*/
+void scatterAddScaledPairs(uint64_t* acc, const int32_t* pairs, int n, uint64_t m);
+
+/**прибавляет к 64-битным суммам \a acc значения \a values, домноженные на \a m (плотный вариант AXPY).
+\a m и значения меньше 2^32.
+*/
+void addScaledDense(uint64_t* acc, const uint32_t* values, int n, uint64_t m);
+
+///возвращает номер первого ненулевого элемента \a a в [\a from;\a to), или \a to, если таких нет
+int findNonZero(const uint64_t* a, int from, int to);
+} //namespace SIMD
+} //namespace F4MPI
+#endif
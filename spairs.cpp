@@ -0,0 +1,174 @@
+/**
+\file
+Реализация множества S-пар и критериев Гебауэра-Мёллера
+*/
+#include "spairs.h"
+#include "commonpolyops.h"
+
+#include <algorithm>
+
+using namespace std;
+namespace F4MPI{
+
+namespace{
+///кандидат в новые пары: элемент базиса и НОК его старшего монома со старшим мономом добавляемого многочлена
+struct NewPair{
+	int index;
+	MonomialID lcm;
+	int degree;
+	bool coprime;
+};
+}
+
+int SPairSet::sugarOf(const CPolynomial& p){
+	int degree=0;
+	for(auto m=p.m_begin();m!=p.m_end();++m) degree=max(degree,m->getDegree());
+	return degree;
+}
+
+void SPairSet::update(PolynomSet& G, const CPolynomial& h, int sugar){
+	//MEASURE_TIME_IN_BLOCK("Update");
+	MonomialTable& table=globalF4MPI::InternedMonomials;
+	const int hIndex=int(polys.size());
+	polys.push_back(h);
+	heads.push_back(h.getMonID(0));
+	sugars.push_back(sugar);
+	//мономы таблицы не перемещаются, поэтому ссылка остаётся действительной при добавлении НОК
+	const CInternalMonomial& hHead=table.get(heads.back());
+
+	//НОК со старшим мономом h для элементов базиса; для прочих многочленов вычисляется при необходимости
+	vector<MonomialID> lcmWithH(polys.size(),MonomialTable::noMonomial);
+	vector<NewPair> candidates;
+	candidates.reserve(active.size());
+	CMonomial lcm;
+	for(int g: active){
+		const CInternalMonomial& gHead=table.get(heads[g]);
+		lcm=CMonomial::lcm(hHead,gHead);
+		const int degree=lcm.getDegree();
+		lcmWithH[g]=table.intern(lcm);
+		candidates.push_back(NewPair{g,lcmWithH[g],degree,degree==hHead.getDegree()+gHead.getDegree()});
+	}
+	auto lcmWithHIs=[&](int g, MonomialID l){
+		if (lcmWithH[g]!=MonomialTable::noMonomial) return lcmWithH[g]==l;
+		return CMonomial::lcm(hHead,table.get(heads[g]))==table.get(l);
+	};
+
+	{
+		//MEASURE_TIME_IN_BLOCK("SecondCriteria");
+		//НОК, делящийся на старший моном h, имеет не меньшую степень, а ключ пары не меньше степени её НОК
+		for(auto bucket=byKey.lower_bound(hHead.getDegree());bucket!=byKey.end();){
+			vector<Pair>& pairs=bucket->second;
+			const size_t before=pairs.size();
+			pairs.erase(remove_if(pairs.begin(),pairs.end(),[&](const Pair& p){
+				return table.get(p.lcm).divisibleBy(hHead) && !lcmWithHIs(p.first,p.lcm) && !lcmWithHIs(p.second,p.lcm);
+			}),pairs.end());
+			pairCount-=before-pairs.size();
+			if (pairs.empty()){
+				bucket=byKey.erase(bucket);
+			}else{
+				++bucket;
+			}
+		}
+	}
+
+	{
+		//MEASURE_TIME_IN_BLOCK("MakeNewSPairs");
+		//кандидаты по возрастанию степени НОК; кандидаты с одинаковым НОК идут подряд в порядке элементов базиса
+		stable_sort(candidates.begin(),candidates.end(),[](const NewPair& a, const NewPair& b){
+			if (a.degree!=b.degree) return a.degree<b.degree;
+			return a.lcm<b.lcm;
+		});
+		//различные НОК оставшихся групп; собственный делитель НОК имеет меньшую степень и потому уже среди них
+		vector<MonomialID> minimal;
+		for(size_t from=0;from<candidates.size();){
+			size_t to=from;
+			bool coprime=false;
+			for(;to<candidates.size() && candidates[to].lcm==candidates[from].lcm;++to) coprime|=candidates[to].coprime;
+			const CInternalMonomial& groupLcm=table.get(candidates[from].lcm);
+			bool divisible=false;
+			for(MonomialID m: minimal){
+				if (groupLcm.divisibleBy(table.get(m))){
+					divisible=true;
+					break;
+				}
+			}
+			if (!divisible){
+				minimal.push_back(candidates[from].lcm);
+				const NewPair& last=candidates[to-1];
+				if (!coprime && (!degreeCap || last.degree<=degreeCap)){
+					//сахар пары - наибольший из сахаров многочленов, домноженных до НОК
+					const int pairSugar=max(sugars[last.index]+last.degree-table.get(heads[last.index]).getDegree(),
+						sugar+last.degree-hHead.getDegree());
+					const Pair p={last.index,hIndex,last.lcm,last.degree,pairSugar};
+					byKey[keyOf(p)].push_back(p);
+					++pairCount;
+				}
+			}
+			from=to;
+		}
+	}
+
+	{
+		//MEASURE_TIME_IN_BLOCK("CheckDivisibility");
+		vector<int> removed;
+		activeHeads.removeMultiples(hHead,removed);
+		activeHeads.insert(heads[hIndex],hIndex);
+		if (removed.empty()){
+			active.push_back(hIndex);
+			G.push_back(h);
+			return;
+		}
+		//старшие мономы элементов базиса различны, поэтому удаляемые элементы G определяются старшими мономами
+		vector<MonomialID> removedHeads;
+		for(int g: removed) removedHeads.push_back(heads[g]);
+		sort(removed.begin(),removed.end());
+		sort(removedHeads.begin(),removedHeads.end());
+		active.erase(remove_if(active.begin(),active.end(),[&](int g){
+			return binary_search(removed.begin(),removed.end(),g);
+		}),active.end());
+		active.push_back(hIndex);
+		vector<bool> Mark(G.size()+1,true);
+		for(int i=0;i<int(G.size());i++)
+		{
+			if(binary_search(removedHeads.begin(),removedHeads.end(),G[i].getMonID(0)))
+				Mark[i]=false;
+		}
+		G.push_back(h);
+		EraseAll<CPolynomial>(G, Mark);
+	}
+}
+
+int SPairSet::takeMinimal(vector<Row>& rows){
+	rows.clear();
+	if (byKey.empty()) return 0;
+	MonomialTable& table=globalF4MPI::InternedMonomials;
+	vector<Pair> pairs;
+	pairs.swap(byKey.begin()->second);
+	byKey.erase(byKey.begin());
+	pairCount-=pairs.size();
+	int sugar=0;
+	CMonomial multiplier;
+	rows.reserve(2*pairs.size());
+	for(const Pair& p: pairs){
+		sugar=max(sugar,p.sugar);
+		for(int i: {p.first,p.second}){
+			table.get(p.lcm).tryDivide(table.get(heads[i]),multiplier);
+			rows.push_back(Row{i,table.intern(multiplier)});
+		}
+	}
+	sort(rows.begin(),rows.end(),[](const Row& a, const Row& b){
+		return a.poly!=b.poly ? a.poly<b.poly : a.multiplier<b.multiplier;
+	});
+	rows.erase(unique(rows.begin(),rows.end(),[](const Row& a, const Row& b){
+		return a.poly==b.poly && a.multiplier==b.multiplier;
+	}),rows.end());
+	return sugar;
+}
+
+vector<SPairSet::Pair> SPairSet::pairs()const{
+	vector<Pair> result;
+	for(const auto& bucket: byKey) result.insert(result.end(),bucket.second.begin(),bucket.second.end());
+	return result;
+}
+
+} //namespace F4MPI
@@ -0,0 +1,114 @@
+#ifndef SPairs_h
+#define SPairs_h
+/**
+\file
+Множество S-пар алгоритма F4 и его обновление по критериям Гебауэра-Мёллера.
+*/
+
+#include "types.h"
+#include "monomialtable.h"
+#include "divisorindex.h"
+
+#include <map>
+#include <vector>
+
+namespace F4MPI{
+/**Множество S-пар промежуточного базиса.
+Хранит все многочлены, когда-либо добавленные в базис, а каждую пару - как номера двух из них
+и номер НОК их старших мономов в таблице globalF4MPI::InternedMonomials.
+НОК вычисляется один раз при создании пары, и равенство НОК сводится к сравнению номеров.
+Пары разложены по ключу выбора - степени НОК или сахару пары (см. Strategy):
+пары с наименьшим ключом извлекаются без просмотра остальных,
+а старые пары при добавлении многочлена проверяются, только если их ключ не меньше степени его старшего монома
+(ключ пары не меньше степени её НОК).
+*/
+class SPairSet{
+  public:
+	///стратегия выбора пар (значения F4AlgOptions::sPairSelection)
+	enum Strategy{
+		normalStrategy=0,///<пары с наименьшей степенью НОК
+		sugarStrategy=1///<пары с наименьшим сахаром
+	};
+
+	///S-пара: номера многочленов (см. poly()), номер НОК их старших мономов, степень НОК и сахар
+	struct Pair{
+		int first, second;
+		MonomialID lcm;
+		int degree;
+		int sugar;
+	};
+
+	///строка матрицы, порождаемая S-парой: многочлен с номером poly (см. poly()), умноженный на моном с номером multiplier
+	struct Row{
+		int poly;
+		MonomialID multiplier;
+	};
+  private:
+	Strategy strategy;
+	///наибольшая степень НОК создаваемых пар; 0 - без ограничения
+	int degreeCap;
+	///все многочлены, добавленные в базис; пары ссылаются на их номера
+	std::vector<CPolynomial> polys;
+	///номера старших мономов polys
+	std::vector<MonomialID> heads;
+	///сахар polys
+	std::vector<int> sugars;
+	///номера в polys элементов промежуточного базиса (порядок элементов в самом базисе меняется при препроцессинге)
+	std::vector<int> active;
+	///старшие мономы элементов active с их номерами в polys
+	DivisorIndex activeHeads;
+	///пары по ключу выбора
+	std::map<int, std::vector<Pair> > byKey;
+	///число пар
+	size_t pairCount;
+
+	int keyOf(const Pair& p)const{
+		return strategy==sugarStrategy ? p.sugar : p.degree;
+	}
+  public:
+	/**\param strategy стратегия выбора пар
+	\param degreeCap наибольшая степень НОК пар; пары большей степени не создаются, и результатом F4 становится базис,
+	усечённый по этой степени. 0 - без ограничения
+	*/
+	explicit SPairSet(Strategy strategy=normalStrategy, int degreeCap=0): strategy(strategy), degreeCap(degreeCap), pairCount(0){}
+
+	///сахар исходного многочлена - его полная степень
+	static int sugarOf(const CPolynomial& p);
+
+	bool empty()const{
+		return !pairCount;
+	}
+
+	size_t size()const{
+		return pairCount;
+	}
+
+	///многочлен с номером \a i, на который ссылаются пары
+	const CPolynomial& poly(int i)const{
+		return polys[i];
+	}
+
+	/**реализация алгоритма Update (в форме Гебауэра-Мёллера).
+	Добавляет многочлен \a h в промежуточный базис \a G, создавая новые пары и удаляя лишние по критериям Бухбергера.
+	НОК старшего монома \a h со старшими мономами элементов базиса вычисляются по одному разу.
+	Из новых пар остаются пары с минимальными по делимости НОК, по одной на каждый НОК и ни одной, если среди пар с таким НОК
+	есть пара взаимно простых старших мономов; затем отбрасываются пары взаимно простых старших мономов.
+	Старая пара удаляется, если её НОК делится на старший моном \a h и отличен от НОК старшего монома \a h со старшими мономами пары.
+	Элементы базиса, старшие мономы которых делятся на старший моном \a h, удаляются из \a G.
+	\param G промежуточный базис, составленный из многочленов, добавленных через update() этого же множества пар
+	\param sugar сахар \a h: sugarOf() для исходных многочленов и значение, возвращённое takeMinimal(), для полученных редукцией
+	*/
+	void update(PolynomSet& G, const CPolynomial& h, int sugar);
+
+	/**извлекает все пары с наименьшим ключом выбора, записывая в \a rows порождаемые ими строки матрицы.
+	Каждый многочлен пары домножается до НОК старших мономов пары; одинаковые строки разных пар записываются один раз.
+	Сами произведения не вычисляются.
+	\retval наибольший сахар извлечённых пар
+	*/
+	int takeMinimal(std::vector<Row>& rows);
+
+	///возвращает все пары (в порядке возрастания ключа выбора)
+	std::vector<Pair> pairs()const;
+};
+} //namespace F4MPI
+#endif
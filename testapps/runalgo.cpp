@@ -27,6 +27,13 @@ CMDLineOption cmdlineoptions[]={
 	{"--MPIblock","MPIB", "lines in reducer block",  &ProgramOptions::MPIBlockSize, CMDLineOption::cmdopt_int},
 	{"--MPIbig","MBIG", "minimize number of sends", &ProgramOptions::MPIUseBigSends, CMDLineOption::cmdopt_bool},
 	{"--rowsz","SROW", "select reducing row by size", &ProgramOptions::useSizesForSelectingRow, CMDLineOption::cmdopt_bool},
+	{"--abcd","ABCD", "use A|B/C|D block decomposition", &ProgramOptions::useABCDDecomposition, CMDLineOption::cmdopt_bool},
+	{"--dense","DACC", "reduce rows in dense accumulator", &ProgramOptions::useDenseAccumulator, CMDLineOption::cmdopt_bool},
+	{"--threads","THRD", "threads per process", &ProgramOptions::numberOfThreads, CMDLineOption::cmdopt_int},
+	{"--densefill","DFIL", "min filling (%) of D block for dense elimination, 0=off", &ProgramOptions::denseBlockFilling, CMDLineOption::cmdopt_int},
+	{"--gf2","GF2B", "bit-packed elimination for modulus 2", &ProgramOptions::useGF2Engine, CMDLineOption::cmdopt_bool},
+	{"--select","SSEL", "S-pair selection: 0=normal, 1=sugar", &ProgramOptions::sPairSelection, CMDLineOption::cmdopt_int},
+	{"--degcap","SCAP", "max S-pair degree (truncated basis), 0=off", &ProgramOptions::sPairDegreeCap, CMDLineOption::cmdopt_int},
 	{"--time",0, "profile time", &ProgramOptions::profileTime, CMDLineOption::cmdopt_bool},
 //	{"--shedul","SHED","use sheduler to select next reducer processor", &CMatrix::matrixSheduler, CMDLineOption::cmdopt_bool},
 //	{"--circul","CIRC","method of process circulation (0-3)", &MPI_PROCESS_CIRCULATE_ORDER, CMDLineOption::cmdopt_int},
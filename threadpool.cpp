@@ -0,0 +1,128 @@
+/**
+\file
+Реализация пула потоков
+*/
+#include "threadpool.h"
+
+using namespace std;
+namespace F4MPI{
+
+ThreadPool::ThreadPool(int threads):
+		currentTask(0),
+		ranges(max(threads,1)),
+		generation(0),
+		busyWorkers(0),
+		stopping(false)
+{
+	for (int i=1;i<threads;++i){
+		workers.push_back(thread(&ThreadPool::workerLoop,this,i));
+	}
+}
+
+ThreadPool::~ThreadPool(){
+	{
+		lock_guard<std::mutex> lock(mutex);
+		stopping=true;
+	}
+	wakeUp.notify_all();
+	for (auto& worker: workers){
+		worker.join();
+	}
+}
+
+int ThreadPool::popOwnTask(int slot){
+	TaskRange& r=ranges[slot];
+	lock_guard<std::mutex> lock(r.lock);
+	if (r.from>=r.to) return -1;
+	return r.from++;
+}
+
+bool ThreadPool::stealTasks(int slot){
+	for(;;){
+		//ищем поток с наибольшим числом невыбранных задач
+		int victim=-1;
+		int victimSize=0;
+		for (int i=0;i<int(ranges.size());++i){
+			if (i==slot) continue;
+			lock_guard<std::mutex> lock(ranges[i].lock);
+			int sz=ranges[i].to-ranges[i].from;
+			if (sz>victimSize){
+				victimSize=sz;
+				victim=i;
+			}
+		}
+		if (victim<0) return false;
+		int from,to;
+		{
+			TaskRange& r=ranges[victim];
+			lock_guard<std::mutex> lock(r.lock);
+			int sz=r.to-r.from;
+			//пока искали, задачи могли разобрать
+			if (sz<=0) continue;
+			to=r.to;
+			from=r.to-(sz+1)/2;
+			r.to=from;
+		}
+		TaskRange& own=ranges[slot];
+		lock_guard<std::mutex> lock(own.lock);
+		own.from=from;
+		own.to=to;
+		return true;
+	}
+}
+
+void ThreadPool::runTasks(int slot){
+	for(;;){
+		int i=popOwnTask(slot);
+		if (i<0){
+			if (!stealTasks(slot)) break;
+			continue;
+		}
+		(*currentTask)(i);
+	}
+}
+
+void ThreadPool::workerLoop(int slot){
+	unsigned seenGeneration=0;
+	for(;;){
+		{
+			unique_lock<std::mutex> lock(mutex);
+			wakeUp.wait(lock,[&]{return stopping || generation!=seenGeneration;});
+			if (stopping) return;
+			seenGeneration=generation;
+		}
+		runTasks(slot);
+		{
+			lock_guard<std::mutex> lock(mutex);
+			if (--busyWorkers==0) allDone.notify_one();
+		}
+	}
+}
+
+void ThreadPool::parallelFor(int taskCount, const Task& task){
+	if (taskCount<=0) return;
+	if (workers.empty() || taskCount==1){
+		for (int i=0;i<taskCount;++i) task(i);
+		return;
+	}
+	{
+		lock_guard<std::mutex> lock(mutex);
+		currentTask=&task;
+		//начальное распределение: равные непрерывные диапазоны
+		const long long slots=ranges.size();
+		for (int i=0;i<int(slots);++i){
+			lock_guard<std::mutex> rangeLock(ranges[i].lock);
+			ranges[i].from=int(taskCount*i/slots);
+			ranges[i].to=int(taskCount*(i+1)/slots);
+		}
+		busyWorkers=workers.size();
+		++generation;
+	}
+	wakeUp.notify_all();
+	runTasks(0);
+	unique_lock<std::mutex> lock(mutex);
+	allDone.wait(lock,[&]{return busyWorkers==0;});
+	currentTask=0;
+}
+
+} //namespace F4MPI
@@ -0,0 +1,85 @@
+#ifndef ThreadPool_h
+#define ThreadPool_h
+/**
+\file
+Пул потоков для параллельной обработки строк матрицы в общей памяти.
+Используется как альтернатива MPI при работе на одной машине:
+потоки создаются один раз и переиспользуются при редукции всех матриц.
+*/
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+namespace F4MPI{
+/**Постоянный пул рабочих потоков.
+Выполняет наборы независимых задач, пронумерованных от 0 до taskCount-1.
+Вызывающий поток также участвует в выполнении задач, поэтому пул размера n создаёт n-1 дополнительных потоков.
+
+Задачи распределяются с перехватом работы (work stealing): каждый поток получает непрерывный диапазон номеров задач
+и выбирает задачи с его начала, а закончив свой диапазон, забирает вторую половину оставшегося диапазона
+у наиболее загруженного потока. Соседние задачи, как правило, выполняются одним потоком,
+а неравномерность времени выполнения задач выравнивается без общего счётчика задач.
+*/
+class ThreadPool{
+  public:
+	///тело задачи, получающее её номер
+	typedef std::function<void(int)> Task;
+
+	///создаёт пул, в котором задачи выполняются \a threads потоками (включая вызывающий)
+	explicit ThreadPool(int threads);
+	~ThreadPool();
+
+	///число потоков, выполняющих задачи (включая вызывающий)
+	int size()const{
+		return int(workers.size())+1;
+	}
+
+	/**выполняет \a task для всех номеров от 0 до \a taskCount-1.
+	Возвращает управление после завершения всех задач. Задачи могут выполняться в произвольном порядке и одновременно.
+	Не допускает вложенных вызовов из выполняемых задач.
+	*/
+	void parallelFor(int taskCount, const Task& task);
+
+  private:
+	ThreadPool(const ThreadPool&);
+	void operator=(const ThreadPool&);
+
+	/**непрерывный диапазон ещё не выбранных задач одного потока.
+	Владелец выбирает задачи с начала диапазона, другие потоки забирают его конец.
+	*/
+	struct TaskRange{
+		std::mutex lock;
+		int from, to;
+	};
+
+	///цикл рабочего потока с номером \a slot
+	void workerLoop(int slot);
+	///выбирает и выполняет задачи текущего набора, пока они не закончатся во всех диапазонах
+	void runTasks(int slot);
+	///выбирает очередную задачу из диапазона \a slot, или возвращает -1, если он пуст
+	int popOwnTask(int slot);
+	///переносит часть задач из наиболее загруженного диапазона в \a slot; возвращает false, если задач не осталось
+	bool stealTasks(int slot);
+
+	std::vector<std::thread> workers;
+	std::mutex mutex;
+	///сигнал о появлении нового набора задач или о завершении работы
+	std::condition_variable wakeUp;
+	///сигнал о том, что все рабочие потоки закончили текущий набор
+	std::condition_variable allDone;
+
+	///текущий набор задач
+	const Task* currentTask;
+	///диапазоны задач по потокам; диапазон 0 принадлежит вызывающему потоку
+	std::vector<TaskRange> ranges;
+	///номер набора задач, увеличивается при каждом вызове parallelFor()
+	unsigned generation;
+	///число рабочих потоков, ещё не закончивших текущий набор
+	int busyWorkers;
+	bool stopping;
+};
+} //namespace F4MPI
+#endif
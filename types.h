@@ -17,10 +17,8 @@ namespace F4MPI{
 ///представление множества полиномов
 typedef std::vector<CPolynomial> PolynomSet;
 typedef std::deque<CPolynomial> SortedReducersSet;
-///представление S-пар полиномов
-typedef std::pair<CPolynomial, CPolynomial> SPair;
-///представление множества S-пар
-typedef std::vector<SPair> SPairSet;
+///множество S-пар (см. spairs.h)
+class SPairSet;
 typedef CMatrix::Row MatrixRow;
 struct ReduceBySet;
 } //namespace F4MPI